@@ -1,5 +1,30 @@
 #include <iostream>
 #include <utility> // Для std::move
+#include <random> // Для std::uniform_int_distribution та генераторів випадкових чисел
+#include <type_traits> // Для вибору алгоритму сортування за типом ключа
+#include <algorithm> // Для std::stable_sort, std::lower_bound та функцій купи
+#include <vector> // Для результатів top_k та індексу пошуку
+#include <fstream> // Для читання файлу сценарію в пакетному режимі
+#include <iomanip> // Для форматування звіту пакетного режиму
+#include <chrono> // Для вимірювання часу виконання команд
+#include <string> // Для нормалізованих ключів індексу пошуку
+#include <string_view> // Для ключів таблиці інтернування авторів
+#include <unordered_map> // Для таблиць індексу пошуку
+#include <unordered_set> // Для відкидання повторів у результатах пошуку
+#include <deque> // Для рядків інтернованих авторів каталогу
+#include <thread> // Для потоку запису журналу
+#include <mutex> // Для синхронізації з потоком запису журналу
+#include <condition_variable> // Для очікування нових записів у потоці журналу
+#include <filesystem> // Для атомарного перейменування знімка та обрізання журналу
+#include <cstdio> // Для FILE* та fwrite у журналі
+#include <functional> // Для дзеркальної копії стану, з якої потік журналу робить знімки
+#include <climits> // Для меж цілих типів під час розбору чисел
+#ifdef _WIN32
+#include <io.h> // Для _commit
+#else
+#include <unistd.h> // Для fsync
+#include <fcntl.h> // Для open каталогу перед його fsync
+#endif
 
 template <typename T>
 struct t_node {
@@ -15,6 +40,11 @@ class Linked2List {
   protected:
     t_node<T>* sen; // sentinel-вузол
     size_t list_size; // розмір списку
+    // Метод, що перезв'язує count вузлів з масиву nodes у список саме в такому порядку
+    void relink(t_node<T>** nodes, size_t count);
+    // Метод, що записує в out до k перших за компаратором вузлів (впорядкованих), повертає їх кількість
+    template <typename Compare>
+    size_t select_nodes(size_t k, Compare compare, t_node<T>** out) const;
   public:
     // Конструктор за замовченням
     Linked2List();
@@ -81,6 +111,27 @@ class Linked2List {
         friend class Linked2List<T>; // Робимо клас двозв'язного списку дружнім
     };
 
+    /* Клас курсора для відтворення списку у випадковому порядку. Список не змінюється і
+    значення не копіюються: курсор тримає лише таблицю вказівників на вузли і перемішує її
+    ліниво - один крок Фішера-Єйтса на кожен виданий елемент, тож перестановка рівномірна,
+    а якщо відтворення перервати, решта таблиці не перемішується даремно */
+    class shuffle_cursor {
+        t_node<T>** nodes; // Таблиця вказівників на вузли списку
+        size_t count; // Кількість елементів для відтворення
+        size_t position; // Позиція поточного елемента в таблиці (count - все видано)
+        std::mt19937_64 gen; // Генератор для кроків Фішера-Єйтса
+        void pick(); // Ставить на позицію position випадковий з ще не виданих елементів
+      public:
+        shuffle_cursor(const Linked2List& list, unsigned long long seed); // Конструктор з параметрами
+        shuffle_cursor(const shuffle_cursor& other) = delete;
+        shuffle_cursor& operator=(const shuffle_cursor& other) = delete;
+        ~shuffle_cursor(); // Деструктор
+        bool done() const; // Чи видано вже всі елементи
+        shuffle_cursor& operator ++ (); // Перехід до наступного випадкового елемента
+        T& operator * (); // Перевантаженя оператору розіменування
+        T* operator -> (); // Перевантаженя оператору стрілки
+    };
+
     // Метод для вставлення вузла перед іншим вузлом у списку
     void insert_before(iterator it, const T& data);
     // Метод для вставлення вузла після іншого вузла у списку
@@ -127,6 +178,25 @@ class Linked2List {
     void merge(Linked2List& other);
     // Метод (сортування злиттям) з компаратором
     void sort(bool (*compare)(T&, T&));
+    /* Метод стабільного сортування за неспаданням ключа key(T&). Для цілих ключів -
+    порозрядне сортування за O(n), для інших - порівняннями за O(n log n). Вузли лише перезв'язуються */
+    template <typename KeyExtractor>
+    void sort_by_key(KeyExtractor key);
+    /* Метод, що повертає ітератори на k перших елементів у порядку compare (строгий компаратор,
+    рівні елементи - в порядку списку) за O(n log k), без копіювання і без зміни списку */
+    template <typename Compare>
+    std::vector<iterator> top_k(size_t k, Compare compare) const;
+    /* Метод, що повертає ітератор на елемент, який стояв би на позиції n після стабільного сортування
+    за compare (end(), якщо n >= size()), за O(n) в середньому і без зміни списку */
+    template <typename Compare>
+    iterator select_nth(size_t n, Compare compare) const;
+    /* Те саме, але порядок задає ключ (як у sort_by_key): ключі витягуються один раз, тож вибір
+    працює над суцільним масивом і не звертається до вузлів на кожному порівнянні */
+    template <typename KeyExtractor>
+    iterator select_nth_by_key(size_t n, KeyExtractor key) const;
+    // Метод, що перемішує список на місці за O(n) (Фішер-Єйтс над вказівниками на вузли)
+    template <typename RNG>
+    void shuffle(RNG& rng);
     // Метод, що робить класичний список циклічним (аргумент true), або навпаки, робить циклічний список - класичним (аргумент false)
     void circular(const bool makeCirc); 
 };
@@ -239,6 +309,57 @@ T* Linked2List<T>::reverse_iterator::operator -> () {
 }
 
 
+/* *** РЕАЛІЗАЦІЯ МЕТОДІВ КУРСОРА ВИПАДКОВОГО ВІДТВОРЕННЯ (Linked2List<T>::shuffle_cursor) *** */
+
+// Конструктор з параметрами. Збирає вказівники на вузли за один прохід, сам список при цьому не змінюється
+template <typename T>
+Linked2List<T>::shuffle_cursor::shuffle_cursor(const Linked2List& list, unsigned long long seed)
+    : nodes(nullptr), count(list.list_size), position(0), gen(seed) {
+    if (count > 0) {
+        nodes = new t_node<T>*[count];
+        // Рахуємо за розміром, а не до sentinel, щоб курсор працював і для циклічного списку
+        t_node<T>* cur = list.sen -> next;
+        for (size_t i = 0; i < count; ++i, cur = cur -> next)
+            nodes[i] = cur;
+        pick();
+    }
+}
+
+template <typename T>
+Linked2List<T>::shuffle_cursor::~shuffle_cursor() {
+    delete[] nodes;
+}
+
+// Один крок Фішера-Єйтса: обмін позиції position з випадковою позицією з [position, count)
+template <typename T>
+void Linked2List<T>::shuffle_cursor::pick() {
+    std::uniform_int_distribution<size_t> dist(position, count - 1);
+    std::swap(nodes[position], nodes[dist(gen)]);
+}
+
+template <typename T>
+bool Linked2List<T>::shuffle_cursor::done() const {
+    return position >= count;
+}
+
+template <typename T>
+typename Linked2List<T>::shuffle_cursor& Linked2List<T>::shuffle_cursor::operator ++ () {
+    ++position;
+    if (!done()) pick();
+    return *this;
+}
+
+template <typename T>
+T& Linked2List<T>::shuffle_cursor::operator * () {
+    return nodes[position] -> data;
+}
+
+template <typename T>
+T* Linked2List<T>::shuffle_cursor::operator -> () {
+    return &(nodes[position] -> data);
+}
+
+
 /////////////////////////////
 
 /* *** КОНСТРУКТОРИ СПИСКУ (Linked2List<T>) *** */
@@ -502,6 +623,199 @@ void Linked2List<T>::sort(bool (*compare)(T&, T&)) {
         }
     }
 }
+/* Метод стабільного сортування за ключем. Вказівники на вузли збираються в масив; якщо ключ
+цілочисельний, масив сортується порозрядно (LSD, по байту за прохід, з пропуском байтів,
+однакових у всіх ключів - для тривалості пісні лишається 1-2 проходи), інакше -
+std::stable_sort. Після цього вузли перезв'язуються, значення T не копіюються */
+template <typename T>
+template <typename KeyExtractor>
+void Linked2List<T>::sort_by_key(KeyExtractor key) {
+    if (size() <= 1) return;
+    typedef typename std::decay<decltype(key(sen -> next -> data))>::type Key;
+    const bool was_circular = sen -> prev -> next != sen;
+    circular(false);
+    const size_t n = list_size;
+    t_node<T>** nodes = new t_node<T>*[n];
+    size_t i = 0;
+    for (t_node<T>* cur = sen -> next; cur != sen; cur = cur -> next)
+        nodes[i++] = cur;
+
+    if constexpr (std::is_integral<Key>::value && !std::is_same<Key, bool>::value) {
+        typedef typename std::make_unsigned<Key>::type UKey;
+        // Для знакових ключів інвертуємо старший біт, щоб від'ємні йшли перед додатними
+        const UKey flip = std::is_signed<Key>::value ? UKey(UKey(1) << (sizeof(UKey) * 8 - 1)) : UKey(0);
+        struct Item {
+            UKey key;
+            t_node<T>* node;
+        };
+        Item* items = new Item[n];
+        Item* buffer = new Item[n];
+        size_t (*counts)[256] = new size_t[sizeof(UKey)][256]();
+        for (i = 0; i < n; ++i) {
+            items[i].key = UKey(UKey(key(nodes[i] -> data)) ^ flip);
+            items[i].node = nodes[i];
+            for (size_t b = 0; b < sizeof(UKey); ++b)
+                ++counts[b][(items[i].key >> (8 * b)) & 0xFF];
+        }
+        for (size_t b = 0; b < sizeof(UKey); ++b) {
+            if (counts[b][(items[0].key >> (8 * b)) & 0xFF] == n) continue; // байт однаковий у всіх
+            size_t offset = 0;
+            for (size_t d = 0; d < 256; ++d) {
+                size_t c = counts[b][d];
+                counts[b][d] = offset;
+                offset += c;
+            }
+            for (i = 0; i < n; ++i)
+                buffer[counts[b][(items[i].key >> (8 * b)) & 0xFF]++] = items[i];
+            std::swap(items, buffer);
+        }
+        for (i = 0; i < n; ++i)
+            nodes[i] = items[i].node;
+        delete[] counts;
+        delete[] buffer;
+        delete[] items;
+    } else {
+        std::stable_sort(nodes, nodes + n, [&key](t_node<T>* a, t_node<T>* b) {
+            return key(a -> data) < key(b -> data);
+        });
+    }
+
+    relink(nodes, n);
+    delete[] nodes;
+    if (was_circular) circular(true);
+}
+/* Вибір k перших елементів обмеженою купою вказівників на вузли. На вершині купи - "найгірший"
+з відібраних, тому кожен наступний вузол або відкидається одним порівнянням, або заміщує
+вершину за O(log k). Разом O(n log k) часу та O(k) пам'яті. Номер позиції у списку
+розв'язує нічиї, тому результат збігається з початком стабільного сортування */
+template <typename T>
+template <typename Compare>
+size_t Linked2List<T>::select_nodes(size_t k, Compare compare, t_node<T>** out) const {
+    if (k > list_size) k = list_size;
+    if (k == 0) return 0;
+    struct Entry {
+        t_node<T>* node;
+        size_t pos;
+    };
+    auto before = [&compare](const Entry& a, const Entry& b) {
+        if (compare(a.node -> data, b.node -> data)) return true;
+        if (compare(b.node -> data, a.node -> data)) return false;
+        return a.pos < b.pos;
+    };
+    Entry* heap = new Entry[k];
+    size_t count = 0;
+    t_node<T>* cur = sen -> next;
+    // Рахуємо за розміром, а не до sentinel, щоб працювало і для циклічного списку
+    for (size_t pos = 0; pos < list_size; ++pos, cur = cur -> next) {
+        Entry e = { cur, pos };
+        if (count < k) {
+            heap[count++] = e;
+            std::push_heap(heap, heap + count, before);
+        } else if (before(e, heap[0])) {
+            std::pop_heap(heap, heap + count, before);
+            heap[count - 1] = e;
+            std::push_heap(heap, heap + count, before);
+        }
+    }
+    std::sort_heap(heap, heap + count, before);
+    for (size_t i = 0; i < count; ++i)
+        out[i] = heap[i].node;
+    delete[] heap;
+    return count;
+}
+// Метод, що повертає ітератори на k перших у порядку compare елементів
+template <typename T>
+template <typename Compare>
+std::vector<typename Linked2List<T>::iterator> Linked2List<T>::top_k(size_t k, Compare compare) const {
+    if (k > list_size) k = list_size;
+    t_node<T>** nodes = new t_node<T>*[k > 0 ? k : 1];
+    size_t count = select_nodes(k, compare, nodes);
+    std::vector<iterator> result;
+    result.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+        result.push_back(iterator(nodes[i]));
+    delete[] nodes;
+    return result;
+}
+/* Метод, що повертає ітератор на n-й (з нуля) елемент у порядку compare. Купа з n + 1 елементів
+для n порядку size() / 2 (медіана) коштувала б O(n log n), тому пари (вузол, позиція) збираються
+в масив і обробляються std::nth_element; позиція розрізняє рівні елементи, як у top_k */
+template <typename T>
+template <typename Compare>
+typename Linked2List<T>::iterator Linked2List<T>::select_nth(size_t n, Compare compare) const {
+    if (n >= list_size) return end();
+    struct Entry {
+        t_node<T>* node;
+        size_t pos;
+    };
+    std::vector<Entry> entries(list_size);
+    t_node<T>* cur = sen -> next;
+    // Рахуємо за розміром, а не до sentinel, щоб працювало і для циклічного списку
+    for (size_t pos = 0; pos < list_size; ++pos, cur = cur -> next)
+        entries[pos] = Entry{ cur, pos };
+    std::nth_element(entries.begin(), entries.begin() + n, entries.end(), [&compare](const Entry& a, const Entry& b) {
+        if (compare(a.node -> data, b.node -> data)) return true;
+        if (compare(b.node -> data, a.node -> data)) return false;
+        return a.pos < b.pos;
+    });
+    return iterator(entries[n].node);
+}
+// Метод, що повертає ітератор на n-й (з нуля) елемент у порядку зростання ключа
+template <typename T>
+template <typename KeyExtractor>
+typename Linked2List<T>::iterator Linked2List<T>::select_nth_by_key(size_t n, KeyExtractor key) const {
+    if (n >= list_size) return end();
+    typedef typename std::decay<decltype(key(sen -> next -> data))>::type Key;
+    struct Entry {
+        Key key;
+        size_t pos;
+        t_node<T>* node;
+    };
+    std::vector<Entry> entries;
+    entries.reserve(list_size);
+    t_node<T>* cur = sen -> next;
+    for (size_t pos = 0; pos < list_size; ++pos, cur = cur -> next)
+        entries.push_back(Entry{ key(cur -> data), pos, cur });
+    std::nth_element(entries.begin(), entries.begin() + n, entries.end(), [](const Entry& a, const Entry& b) {
+        if (a.key < b.key) return true;
+        if (b.key < a.key) return false;
+        return a.pos < b.pos;
+    });
+    return iterator(entries[n].node);
+}
+// Метод, що перезв'язує count вузлів з масиву nodes у список саме в такому порядку
+template <typename T>
+void Linked2List<T>::relink(t_node<T>** nodes, size_t count) {
+    t_node<T>* prev = sen;
+    for (size_t i = 0; i < count; ++i) {
+        prev -> next = nodes[i];
+        nodes[i] -> prev = prev;
+        prev = nodes[i];
+    }
+    prev -> next = sen;
+    sen -> prev = prev;
+}
+/* Метод, що перемішує список на місці за O(n). Вибір випадкового вузла кроком від begin()
+коштував би O(n) на кожен крок, тому спершу один раз збираємо вказівники на вузли в масив,
+виконуємо над ним алгоритм Фішера-Єйтса і перезв'язуємо вузли. Значення T не копіюються */
+template <typename T>
+template <typename RNG>
+void Linked2List<T>::shuffle(RNG& rng) {
+    if (size() <= 1) return;
+    const bool was_circular = sen -> prev -> next != sen;
+    circular(false);
+    t_node<T>** nodes = new t_node<T>*[list_size];
+    size_t i = 0;
+    for (t_node<T>* cur = sen -> next; cur != sen; cur = cur -> next)
+        nodes[i++] = cur;
+    for (i = list_size - 1; i > 0; --i) {
+        std::uniform_int_distribution<size_t> pick(0, i);
+        std::swap(nodes[i], nodes[pick(rng)]);
+    }
+    relink(nodes, list_size);
+    delete[] nodes;
+    if (was_circular) circular(true);
+}
 /* Метод, що робить зв'язний список циклічним, приймає як аргумент bool значення:
     true, якщо треба зробити із класичного списку зациклений список
     false, якщо з циклічного треба перетворити у класичний */
@@ -520,6 +834,7 @@ void Linked2List<T>::circular(const bool makeCirc) {
 
 template <typename T>
 Linked2List<T>::~Linked2List() {
+    if (sen == nullptr) return; // список було переміщено
     // ЯКЩО КОРИСТУВАЧ ЗАЦИКЛИВ НАШ СПИСОК, ПРИВОДИМО ЙОГО ДО КЛАСИЧНОГО ВИГЛЯДУ, ЩОБ ОЧИСТИТИ ПАМ'ЯТЬ
     if (sen -> prev -> next != sen) {
         circular(false);
@@ -529,149 +844,1646 @@ Linked2List<T>::~Linked2List() {
 }
 
 
-/////////////////////////// ДОПОМІЖНІ ФУНКЦІЇ ///////////////////////////////
+/////////////////////////// ІНТРУЗИВНИЙ СПИСОК ///////////////////////////////
 
-/* Функція перевірки двох рядків (const char* a, const char* b) 
-на рівність (повертає true, якщо рівні та false, якщо ні) */
-bool strcmp_equal(const char* a, const char* b) {
-    size_t i = 0;
-    while (a[i] != '\0' && b[i] != '\0') {
-        if (a[i] != b[i]) return false;
-        ++i;
-    }
-    return a[i] == b[i];
+/* Гачок (hook) інтрузивного списку. Вбудовується полем безпосередньо в об'єкт типу T,
+тому список зв'язує самі об'єкти і не створює для них окремих вузлів. Об'єкт може мати
+кілька гачків і одночасно перебувати в кількох списках (по одному на кожен гачок).
+Гачок відв'язується автоматично, коли об'єкт знищується, тому список ніколи не тримає
+вказівник на знищений об'єкт (як auto_unlink-гачки Boost.Intrusive). Для циклічного
+списку це не діє: там sentinel не входить у кільце, і об'єкти треба відв'язувати явно */
+struct t_hook {
+    t_hook* prev; // Вказівник на попередній гачок
+    t_hook* next; // Вказівник на наступний гачок
+    t_hook(); // Конструктор за замовченням (гачок не зв'язаний)
+    t_hook(const t_hook& other); // Конструктор копіювання (копія об'єкта не потрапляє у списки оригіналу)
+    t_hook& operator=(const t_hook& other); // Присвоєння об'єктів не змінює їх зв'язки
+    ~t_hook(); // Деструктор (відв'язує гачок від сусідів, якщо він ще у списку)
+    bool is_linked() const; // Метод, що перевіряє чи перебуває гачок у якомусь списку
+};
+
+/* Інтрузивний двозв'язний список з sentinel-вузлом. Другий параметр шаблону - вказівник
+на поле-гачок всередині T, через яке об'єкт зв'язується саме в цей список.
+Список не виділяє пам'ять під елементи, не копіює їх і не знищує: він лише зв'язує та
+відв'язує об'єкти, які живуть деінде (каталог, масив, файл у пам'яті тощо).
+Оскільки об'єкт може покинути список сам (знищившись), розмір не зберігається, а
+рахується обходом: size() - O(n), empty() - O(1) */
+template <typename T, t_hook T::*Hook>
+class IntrusiveLinked2List {
+  protected:
+    t_hook* sen; // sentinel-гачок
+    // Метод, що за адресою гачка повертає адресу об'єкта, в який цей гачок вбудовано
+    static T* owner(t_hook* hook);
+  public:
+    // Конструктор за замовченням
+    IntrusiveLinked2List();
+    // Копіювання заборонене: гачок об'єкта може бути лише в одному списку
+    IntrusiveLinked2List(const IntrusiveLinked2List& other) = delete;
+    IntrusiveLinked2List& operator=(const IntrusiveLinked2List& other) = delete;
+    // Конструктор переміщення
+    IntrusiveLinked2List(IntrusiveLinked2List&& other) noexcept;
+    // Деструктор (відв'язує всі об'єкти, але не знищує їх)
+    ~IntrusiveLinked2List();
+
+    // Клас ітератор
+    class iterator {
+        t_hook* ptr; // Поле для зберігання вказівника на поточний гачок
+      public:
+        iterator(); // Конструктор за замовчуванням
+        iterator(t_hook* ptr); // Конструктор з параметром
+        iterator operator ++ (); // Перевантаженя оператору інкремента
+        iterator operator -- (); // Перевантаженя оператору декремента
+        bool operator != (const iterator& guest); // Перевантаженя оператору недорівнює
+        bool operator == (const iterator& guest); // Перевантаженя оператору дорівнює
+        T& operator * (); // Перевантаженя оператору розіменування
+        T* operator->(); // Перевантаженя оператору стрілки
+        friend class IntrusiveLinked2List<T, Hook>; // Робимо клас інтрузивного списку дружнім
+    };
+
+    // Клас реверсний ітератор
+    class reverse_iterator {
+        t_hook* ptr; // Поле для зберігання вказівника на поточний гачок
+      public:
+        reverse_iterator(); // Конструктор за замовчуванням
+        reverse_iterator(t_hook* ptr); // Конструктор з параметром
+        reverse_iterator operator ++ (); // Перевантаженя оператору інкремента
+        reverse_iterator operator -- (); // Перевантаженя оператору декремента
+        bool operator != (const reverse_iterator& guest); // Перевантаженя оператору недорівнює
+        bool operator == (const reverse_iterator& guest); // Перевантаженя оператору дорівнює
+        T& operator * (); // Перевантаженя оператору розіменування
+        T* operator -> (); // Перевантаженя оператору стрілки
+        friend class IntrusiveLinked2List<T, Hook>; // Робимо клас інтрузивного списку дружнім
+    };
+
+    /* Методи зв'язування об'єкта перед/після іншого елемента у списку. Гачок, що вже
+    перебуває в якомусь списку, повторно не зв'язується: методи повертають false */
+    bool insert_before(iterator it, T& value);
+    bool insert_after(iterator it, T& value);
+    // Метод, що відв'язує вибраний елемент від списку (сам об'єкт не знищується)
+    iterator erase(iterator it);
+    // Метод, що відв'язує об'єкт від списку за посиланням на нього, за O(1) (не зв'язаний об'єкт ігнорується)
+    void erase(T& value);
+
+    // Метод для зв'язування об'єкта в кінці списку (false, якщо об'єкт вже у списку)
+    bool push_back(T& value);
+    // Метод для відв'язування останнього елемента списку
+    void pop_back();
+    // Метод для зв'язування об'єкта на початку списку (false, якщо об'єкт вже у списку)
+    bool push_front(T& value);
+    // Метод для відв'язування першого елемента списку
+    void pop_front();
+    // Метод для відв'язування всіх елементів списку
+    void clear();
+    // Метод, що перевіряє чи пустий список
+    bool empty() const;
+
+    // Метод, що повертає ітератор першого елемента списку
+    iterator begin() const;
+    // Метод, що повертає ітератор sentinel-гачка (кінець списку)
+    iterator end() const;
+    // Метод, що повертає реверс ітератор останнього елемента списку
+    reverse_iterator rbegin() const;
+    // Метод, що повертає реверс ітератор sentinel-гачка
+    reverse_iterator rend() const;
+    // Метод, що повертає ітератор на об'єкт, який вже перебуває у цьому списку, за O(1)
+    iterator iterator_to(T& value) const;
+    // Метод, що повертає кількість елементів у списку (обходом, за O(n))
+    size_t size() const;
+
+    // Метод Swap (для обміну вмістом)
+    void swap(IntrusiveLinked2List& other) noexcept;
+    // Метод, що робить класичний список циклічним (аргумент true), або навпаки, робить циклічний список - класичним (аргумент false)
+    void circular(const bool makeCirc);
+};
+
+/* *** РЕАЛІЗАЦІЯ МЕТОДІВ ГАЧКА (t_hook) *** */
+
+t_hook::t_hook() : prev(nullptr), next(nullptr) {}
+
+t_hook::t_hook(const t_hook&) : prev(nullptr), next(nullptr) {}
+
+t_hook& t_hook::operator=(const t_hook&) {
+    return *this;
 }
-// Процедура копіювання рядка (const char* src) у масив (char* dest)
-void strcpy_custom(char* dest, const char* src) {
-    size_t i = 0;
-    while (src[i] != '\0') {
-        dest[i] = src[i];
-        ++i;
-    }
-    dest[i] = '\0';
+
+t_hook::~t_hook() {
+    if (next == nullptr) return;
+    prev -> next = next;
+    next -> prev = prev;
 }
-/* Функція для визначення довжини рядка (const char* str)
-Повертає довжину типу size_t */
-size_t strlen_custom(const char* str) {
-    size_t len = 0;
-    while (str[len] != '\0') ++len;
-    return len;
+
+bool t_hook::is_linked() const {
+    return next != nullptr;
 }
 
-/////////////////////////// СТРУКТУРА ПІСНІ ///////////////////////////////
+/* *** РЕАЛІЗАЦІЯ МЕТОДІВ ІТЕРАТОРІВ ІНТРУЗИВНОГО СПИСКУ *** */
 
-struct Song {
-    char* name; // Назва пісні
-    char* author; // Ім'я автора
-    int duration; // Довжина пісні в секундах
-    // Конструктор за замовчуванням
-    Song() : name(nullptr), author(nullptr), duration(0) {
-        // Створюємо масиви типу char розмірності 1
-        name = new char[1];
-        name[0] = '\0';
-        author = new char[1];
-        author[0] = '\0';
-    }
-    // Конструктор з параметром
-    Song(const char* n, const char* a, int d) : duration(d) {
-        // визначаємо довжину рядка
-        size_t len = strlen_custom(n) + 1;
-        // виділяємо пам'ять під масиви та заповнюємо їх значеннями
-        name = new char[len];
-        strcpy_custom(name, n);
-        // так само для другого рядка
-        len = strlen_custom(a) + 1;
-        author = new char[len];
-        strcpy_custom(author, a);
-    }
-    
-    // Конструктор копіювання
-    Song(const Song& other) : duration(other.duration) {
-        // визначаємо довжину рядка
-        size_t len = strlen_custom(other.name) + 1;
-        // виділяємо пам'ять під масиви та заповнюємо їх значеннями
-        name = new char[len];
-        strcpy_custom(name, other.name);
-        // так само для другого рядка
-        len = strlen_custom(other.author) + 1;
-        author = new char[len];
-        strcpy_custom(author, other.author);
-    }
-    // Перевантаження оператору присвоєння, повертає посилання (Song&) на поточний об'єкт
-    Song& operator=(const Song& other) {
-        if (this != &other) {
-            delete[] name;
-            delete[] author;
-            // визначаємо довжину рядка
-            size_t len = strlen_custom(other.name) + 1;
-            // виділяємо пам'ять під масиви та заповнюємо їх значеннями
-            name = new char[len];
-            strcpy_custom(name, other.name);
-            // так само для другого рядка
-            len = strlen_custom(other.author) + 1;
-            author = new char[len];
-            strcpy_custom(author, other.author);
-            duration = other.duration;
-        }
-        return *this;
-    }
-    /* Перевантаження оператору == (порівняння на рівність всіх полів двох об'єктів типу Song), 
-    повертає true, в разі рівності і false, в разі нерівності */
-    bool operator==(const Song& other) const {
-        return strcmp_equal(name, other.name) && strcmp_equal(author, other.author) && duration == other.duration;
-    }
-    /* Перевантаження оператору != (порівняння на нерівність полів двох об'єктів типу Song), 
-    повертає true, в разі нерівності хоч одного поля, false в разі повної рівності */
-    bool operator!=(const Song& other) const {
-        return !(*this == other);
-    }
-    /* Перевантаження оператору < (порівняння часу), в разі якщо в полі значення duration поточного об'єкту
-    менше, ніж у переданого, повертає true, в протилежному випадку - false*/
-    bool operator<(const Song& other) const {
-        return duration < other.duration;
-    }
-    /* Перевантаження оператору > (порівняння часу), в разі якщо в полі значення duration поточного об'єкту
-    більше, ніж у переданого, повертає true, в протилежному випадку - false*/
-    bool operator>(const Song& other) const {
-        return duration > other.duration;
-    }
-    // Перевантаження оператору <= (менше за часом або рівні) логічне об'єднання вже реалізованих (== та <)
-    bool operator<=(const Song& other) const {
-        return (*this < other) || (*this == other);
-    }
-    // Перевантаження оператору >= (більше за часом або рівні) логічне об'єднання вже реалізованих (== та >)
-    bool operator>=(const Song& other) const {
-        return (*this > other) || (*this == other);
-    }
-    // Деструктор
-    ~Song() {
-        delete[] name;
-        delete[] author;
-    }
-};
+template <typename T, t_hook T::*Hook>
+IntrusiveLinked2List<T, Hook>::iterator::iterator() : ptr(nullptr) {}
 
-/////////////////////////// УНАРНІ ПРЕДИКАТИ ТА КОМПАРАТОРИ ///////////////////////////////
+template <typename T, t_hook T::*Hook>
+IntrusiveLinked2List<T, Hook>::iterator::iterator(t_hook* ptr) : ptr(ptr) {}
 
-// Компаратор, аргументами є два посилання(Song&) на об'єкти а та b
-// Повертає true, якщо довжина пісні a менша або дорівнює довжині пісні b 
-// false в протилежному випадку
-bool compare_by_duration(Song& a, Song& b) {
-    return a.duration <= b.duration;
+template <typename T, t_hook T::*Hook>
+typename IntrusiveLinked2List<T, Hook>::iterator IntrusiveLinked2List<T, Hook>::iterator::operator ++ () {
+    ptr = ptr -> next;
+    return *this;
 }
-// Унарний предикат, аргументом є посилання(Song&) на об'єкт а
-// Повертає true, в разі якщо довжина пісні більша за 5 хв (300 с), false в протилежному випадку
-bool is_long_song(Song& s) {
-    return s.duration > 300; // більше 5 хвилин
+
+template <typename T, t_hook T::*Hook>
+typename IntrusiveLinked2List<T, Hook>::iterator IntrusiveLinked2List<T, Hook>::iterator::operator -- () {
+    ptr = ptr -> prev;
+    return *this;
 }
-// Унарний предикат, аргументом є посилання(Song&) на об'єкт а
-// Повертає true, в разі якщо довжина пісні менша за 3 хв (180 с), false в протилежному випадку
-bool is_short_song(Song& s) {
-    return s.duration < 180; // менше 3 хвилин
+
+template <typename T, t_hook T::*Hook>
+bool IntrusiveLinked2List<T, Hook>::iterator::operator != (const iterator& guest) {
+    return ptr != guest.ptr;
 }
 
-/////////////////////////// ОСНОВНА ПРОГРАМА ///////////////////////////////
+template <typename T, t_hook T::*Hook>
+bool IntrusiveLinked2List<T, Hook>::iterator::operator == (const iterator& guest) {
+    return ptr == guest.ptr;
+}
 
-// Процедура для виводу у вихідний потік інструкції для користувача
+template <typename T, t_hook T::*Hook>
+T& IntrusiveLinked2List<T, Hook>::iterator::operator * () {
+    return *owner(ptr);
+}
+
+template <typename T, t_hook T::*Hook>
+T* IntrusiveLinked2List<T, Hook>::iterator::operator -> () {
+    return owner(ptr);
+}
+
+template <typename T, t_hook T::*Hook>
+IntrusiveLinked2List<T, Hook>::reverse_iterator::reverse_iterator() : ptr(nullptr) {}
+
+template <typename T, t_hook T::*Hook>
+IntrusiveLinked2List<T, Hook>::reverse_iterator::reverse_iterator(t_hook* ptr) : ptr(ptr) {}
+
+template <typename T, t_hook T::*Hook>
+typename IntrusiveLinked2List<T, Hook>::reverse_iterator IntrusiveLinked2List<T, Hook>::reverse_iterator::operator ++ () {
+    ptr = ptr -> prev;
+    return *this;
+}
+
+template <typename T, t_hook T::*Hook>
+typename IntrusiveLinked2List<T, Hook>::reverse_iterator IntrusiveLinked2List<T, Hook>::reverse_iterator::operator -- () {
+    ptr = ptr -> next;
+    return *this;
+}
+
+template <typename T, t_hook T::*Hook>
+bool IntrusiveLinked2List<T, Hook>::reverse_iterator::operator != (const reverse_iterator& guest) {
+    return ptr != guest.ptr;
+}
+
+template <typename T, t_hook T::*Hook>
+bool IntrusiveLinked2List<T, Hook>::reverse_iterator::operator == (const reverse_iterator& guest) {
+    return ptr == guest.ptr;
+}
+
+template <typename T, t_hook T::*Hook>
+T& IntrusiveLinked2List<T, Hook>::reverse_iterator::operator * () {
+    return *owner(ptr);
+}
+
+template <typename T, t_hook T::*Hook>
+T* IntrusiveLinked2List<T, Hook>::reverse_iterator::operator -> () {
+    return owner(ptr);
+}
+
+/* *** КОНСТРУКТОРИ ТА МЕТОДИ ІНТРУЗИВНОГО СПИСКУ (IntrusiveLinked2List<T, Hook>) *** */
+
+/* Зміщення гачка всередині T однакове для всіх об'єктів типу, тому обчислюємо його
+один раз на "сирій" пам'яті розміру T, не створюючи сам об'єкт */
+template <typename T, t_hook T::*Hook>
+T* IntrusiveLinked2List<T, Hook>::owner(t_hook* hook) {
+    alignas(T) static unsigned char probe[sizeof(T)];
+    static const size_t offset = reinterpret_cast<char*>(&(reinterpret_cast<T*>(probe) ->* Hook))
+                                 - reinterpret_cast<char*>(probe);
+    return reinterpret_cast<T*>(reinterpret_cast<char*>(hook) - offset);
+}
+// Конструктор за замовченням
+template <typename T, t_hook T::*Hook>
+IntrusiveLinked2List<T, Hook>::IntrusiveLinked2List() : sen(new t_hook) {
+    sen -> prev = sen;
+    sen -> next = sen;
+}
+// Конструктор переміщення
+template <typename T, t_hook T::*Hook>
+IntrusiveLinked2List<T, Hook>::IntrusiveLinked2List(IntrusiveLinked2List&& other) noexcept : sen(other.sen) {
+    other.sen = nullptr;
+}
+// Метод для зв'язування об'єкта перед іншим елементом у списку
+template <typename T, t_hook T::*Hook>
+bool IntrusiveLinked2List<T, Hook>::insert_before(iterator it, T& value) {
+    t_hook* node = &(value.*Hook);
+    if (node -> is_linked()) return false; // інакше зіпсували б обидва списки
+    node -> next = it.ptr;
+    node -> prev = it.ptr -> prev;
+    it.ptr -> prev -> next = node;
+    it.ptr -> prev = node;
+    return true;
+}
+// Метод для зв'язування об'єкта після іншого елемента у списку
+template <typename T, t_hook T::*Hook>
+bool IntrusiveLinked2List<T, Hook>::insert_after(iterator it, T& value) {
+    t_hook* node = &(value.*Hook);
+    if (node -> is_linked()) return false; // інакше зіпсували б обидва списки
+    node -> next = it.ptr -> next;
+    node -> prev = it.ptr;
+    it.ptr -> next -> prev = node;
+    it.ptr -> next = node;
+    return true;
+}
+/* Метод, що відв'язує обраний елемент списку та повертає ітератор на наступний.
+Як і в Linked2List, у циклічному режимі sentinel не входить у кільце, тому
+при видаленні першого/останнього елемента оновлюємо і його вказівники */
+template <typename T, t_hook T::*Hook>
+typename IntrusiveLinked2List<T, Hook>::iterator IntrusiveLinked2List<T, Hook>::erase(iterator it) {
+    t_hook* node = it.ptr;
+    t_hook* next_elem = node -> next;
+    if (sen -> next == node && sen -> prev == node) { // єдиний елемент
+        sen -> next = sen;
+        sen -> prev = sen;
+        next_elem = sen;
+    } else {
+        if (node == sen -> prev && sen -> prev -> next != sen) {
+            sen -> prev = node -> prev;
+        } else if (node == sen -> next && sen -> next -> prev != sen) {
+            sen -> next = node -> next;
+        }
+        node -> prev -> next = node -> next;
+        node -> next -> prev = node -> prev;
+    }
+    node -> prev = nullptr;
+    node -> next = nullptr;
+    return iterator(next_elem);
+}
+// Метод, що відв'язує об'єкт від списку за посиланням на нього, за O(1)
+template <typename T, t_hook T::*Hook>
+void IntrusiveLinked2List<T, Hook>::erase(T& value) {
+    if (!(value.*Hook).is_linked()) return;
+    erase(iterator_to(value));
+}
+// Метод для зв'язування об'єкта в кінці списку
+template <typename T, t_hook T::*Hook>
+bool IntrusiveLinked2List<T, Hook>::push_back(T& value) {
+    return insert_before(end(), value);
+}
+// Метод для відв'язування останнього елемента списку
+template <typename T, t_hook T::*Hook>
+void IntrusiveLinked2List<T, Hook>::pop_back() {
+    if (empty()) return;
+    erase(iterator(sen -> prev));
+}
+// Метод для зв'язування об'єкта на початку списку
+template <typename T, t_hook T::*Hook>
+bool IntrusiveLinked2List<T, Hook>::push_front(T& value) {
+    return insert_after(end(), value);
+}
+// Метод для відв'язування першого елемента списку
+template <typename T, t_hook T::*Hook>
+void IntrusiveLinked2List<T, Hook>::pop_front() {
+    if (empty()) return;
+    erase(begin());
+}
+// Метод для відв'язування всіх елементів списку (гачки об'єктів знову стають вільними)
+template <typename T, t_hook T::*Hook>
+void IntrusiveLinked2List<T, Hook>::clear() {
+    while (!empty()) {
+        pop_back();
+    }
+}
+// Метод, що перевіряє чи пустий список
+template <typename T, t_hook T::*Hook>
+bool IntrusiveLinked2List<T, Hook>::empty() const {
+    return sen -> next == sen;
+}
+// Метод, що повертає ітератор першого елемента списку
+template <typename T, t_hook T::*Hook>
+typename IntrusiveLinked2List<T, Hook>::iterator IntrusiveLinked2List<T, Hook>::begin() const {
+    return iterator(sen -> next);
+}
+// Метод, що повертає ітератор sentinel-гачка (кінець списку)
+template <typename T, t_hook T::*Hook>
+typename IntrusiveLinked2List<T, Hook>::iterator IntrusiveLinked2List<T, Hook>::end() const {
+    return iterator(sen);
+}
+// Метод, що повертає реверс ітератор останнього елемента списку
+template <typename T, t_hook T::*Hook>
+typename IntrusiveLinked2List<T, Hook>::reverse_iterator IntrusiveLinked2List<T, Hook>::rbegin() const {
+    return reverse_iterator(sen -> prev);
+}
+// Метод, що повертає реверс ітератор sentinel-гачка
+template <typename T, t_hook T::*Hook>
+typename IntrusiveLinked2List<T, Hook>::reverse_iterator IntrusiveLinked2List<T, Hook>::rend() const {
+    return reverse_iterator(sen);
+}
+// Метод, що повертає ітератор на об'єкт, який вже перебуває у цьому списку
+template <typename T, t_hook T::*Hook>
+typename IntrusiveLinked2List<T, Hook>::iterator IntrusiveLinked2List<T, Hook>::iterator_to(T& value) const {
+    return iterator(&(value.*Hook));
+}
+/* Метод, що повертає кількість елементів у списку (тип size_t). Обхід іде до останнього
+елемента, а не до sentinel, щоб працювати і для циклічного списку */
+template <typename T, t_hook T::*Hook>
+size_t IntrusiveLinked2List<T, Hook>::size() const {
+    if (empty()) return 0;
+    size_t count = 1;
+    for (t_hook* cur = sen -> next; cur != sen -> prev; cur = cur -> next) ++count;
+    return count;
+}
+// Метод Swap (для обміну вмістом двох списків)
+template <typename T, t_hook T::*Hook>
+void IntrusiveLinked2List<T, Hook>::swap(IntrusiveLinked2List& other) noexcept {
+    std::swap(sen, other.sen);
+}
+/* Метод, що робить зв'язний список циклічним, приймає як аргумент bool значення:
+    true, якщо треба зробити із класичного списку зациклений список
+    false, якщо з циклічного треба перетворити у класичний */
+template <typename T, t_hook T::*Hook>
+void IntrusiveLinked2List<T, Hook>::circular(const bool makeCirc) {
+    if (empty()) return;
+    if (makeCirc && sen -> prev -> next == sen) {
+        sen -> prev -> next = sen -> next;
+        sen -> next -> prev = sen -> prev;
+    } else if (!makeCirc && sen -> prev -> next != sen) {
+        sen -> prev -> next = sen;
+        sen -> next -> prev = sen;
+    }
+}
+
+/* *** ДЕСТРУКТОР ІНТРУЗИВНОГО СПИСКУ *** */
+
+template <typename T, t_hook T::*Hook>
+IntrusiveLinked2List<T, Hook>::~IntrusiveLinked2List() {
+    if (sen == nullptr) return; // список було переміщено
+    // Так само, як у Linked2List, спершу розмикаємо кільце
+    circular(false);
+    clear();
+    delete sen;
+}
+
+
+/////////////////////////// ЛІНИВІ ПОДАННЯ СПИСКУ ///////////////////////////////
+
+/* Подання (views) - легкі об'єкти, що не володіють елементами і нічого не копіюють.
+Вони лише описують, як обходити список: відбір (filter), перетворення (transform),
+перші n (take), пропуск n (drop) та зворотний порядок (reverse, на основі reverse_iterator).
+Подання комбінуються оператором |, а обчислюються лише під час обходу:
+    for (auto& s : playlist | views::filter(is_long_song) | views::take(50)) ...
+Новий список створюється лише на явний запит: views::to_list(подання).
+Подання лишається дійсним, поки існують вузли списку, на які воно посилається */
+namespace views {
+
+// Базове подання: діапазон [first, last) ітераторів списку
+template <typename Iter>
+class range_view {
+    Iter first; // Перший елемент
+    Iter last; // Елемент після останнього
+  public:
+    typedef Iter iterator;
+    range_view(Iter first, Iter last) : first(first), last(last) {}
+    iterator begin() const { return first; }
+    iterator end() const { return last; }
+};
+
+// Подання, що пропускає елементи, для яких предикат повертає false
+template <typename Base, typename Pred>
+class filter_view {
+    Base base; // Подання, яке фільтруємо
+    Pred pred; // Унарний предикат
+  public:
+    class iterator {
+        typename Base::iterator cur; // Поточна позиція в базовому поданні
+        typename Base::iterator last; // Кінець базового подання
+        const Pred* pred; // Предикат подання
+        // Метод, що зсуває cur до першого елемента, який задовольняє предикат
+        void skip() {
+            while (cur != last && !(*pred)(*cur)) ++cur;
+        }
+      public:
+        iterator(typename Base::iterator cur, typename Base::iterator last, const Pred* pred)
+            : cur(cur), last(last), pred(pred) { skip(); }
+        iterator operator ++ () { ++cur; skip(); return *this; }
+        bool operator != (const iterator& guest) { return cur != guest.cur; }
+        bool operator == (const iterator& guest) { return cur == guest.cur; }
+        decltype(auto) operator * () { return *cur; }
+    };
+    filter_view(Base base, Pred pred) : base(base), pred(pred) {}
+    iterator begin() const { return iterator(base.begin(), base.end(), &pred); }
+    iterator end() const { return iterator(base.end(), base.end(), &pred); }
+};
+
+// Подання, що повертає f(елемент) замість самого елемента (обчислюється при розіменуванні)
+template <typename Base, typename F>
+class transform_view {
+    Base base; // Подання, яке перетворюємо
+    F f; // Функція перетворення
+  public:
+    class iterator {
+        typename Base::iterator cur; // Поточна позиція в базовому поданні
+        const F* f; // Функція перетворення
+      public:
+        iterator(typename Base::iterator cur, const F* f) : cur(cur), f(f) {}
+        iterator operator ++ () { ++cur; return *this; }
+        bool operator != (const iterator& guest) { return cur != guest.cur; }
+        bool operator == (const iterator& guest) { return cur == guest.cur; }
+        decltype(auto) operator * () { return (*f)(*cur); }
+    };
+    transform_view(Base base, F f) : base(base), f(f) {}
+    iterator begin() const { return iterator(base.begin(), &f); }
+    iterator end() const { return iterator(base.end(), &f); }
+};
+
+// Подання з не більше ніж count перших елементів
+template <typename Base>
+class take_view {
+    Base base; // Базове подання
+    size_t count; // Скільки елементів взяти
+  public:
+    class iterator {
+        typename Base::iterator cur; // Поточна позиція в базовому поданні
+        size_t remaining; // Скільки елементів ще можна видати (0 - кінець)
+      public:
+        iterator(typename Base::iterator cur, size_t remaining) : cur(cur), remaining(remaining) {}
+        /* Базовий ітератор зсувається лише поки ліміт не вичерпано: інакше над filter
+        останній ++ проглядав би решту списку в пошуках наступного збігу */
+        iterator operator ++ () {
+            if (--remaining > 0) ++cur;
+            return *this;
+        }
+        // Ітератори рівні, якщо обидва вичерпали ліміт або стоять на одному елементі
+        bool operator == (const iterator& guest) {
+            return (remaining == 0 && guest.remaining == 0) || cur == guest.cur;
+        }
+        bool operator != (const iterator& guest) { return !(*this == guest); }
+        decltype(auto) operator * () { return *cur; }
+    };
+    take_view(Base base, size_t count) : base(base), count(count) {}
+    iterator begin() const { return iterator(base.begin(), count); }
+    iterator end() const { return iterator(base.end(), 0); }
+};
+
+// Подання без перших count елементів (пропуск виконується під час виклику begin())
+template <typename Base>
+class drop_view {
+    Base base; // Базове подання
+    size_t count; // Скільки елементів пропустити
+  public:
+    typedef typename Base::iterator iterator;
+    drop_view(Base base, size_t count) : base(base), count(count) {}
+    iterator begin() const {
+        iterator it = base.begin();
+        iterator last = base.end();
+        for (size_t i = 0; i < count && it != last; ++i) ++it;
+        return it;
+    }
+    iterator end() const { return base.end(); }
+};
+
+// Адаптери - аргументи правої частини оператора |
+template <typename Pred> struct filter_adaptor { Pred pred; };
+template <typename F> struct transform_adaptor { F f; };
+struct take_adaptor { size_t count; };
+struct drop_adaptor { size_t count; };
+struct reverse_adaptor {};
+
+// Функції, що створюють адаптери
+template <typename Pred>
+filter_adaptor<Pred> filter(Pred pred) { return filter_adaptor<Pred>{ pred }; }
+template <typename F>
+transform_adaptor<F> transform(F f) { return transform_adaptor<F>{ f }; }
+inline take_adaptor take(size_t count) { return take_adaptor{ count }; }
+inline drop_adaptor drop(size_t count) { return drop_adaptor{ count }; }
+inline reverse_adaptor reverse() { return reverse_adaptor{}; }
+
+// Функція, що повертає подання всього списку
+template <typename T>
+range_view<typename Linked2List<T>::iterator> all(const Linked2List<T>& list) {
+    return range_view<typename Linked2List<T>::iterator>(list.begin(), list.end());
+}
+// Функція, що повертає подання всього списку у зворотному порядку
+template <typename T>
+range_view<typename Linked2List<T>::reverse_iterator> reversed(const Linked2List<T>& list) {
+    return range_view<typename Linked2List<T>::reverse_iterator>(list.rbegin(), list.rend());
+}
+
+// Оператори | для подань
+template <typename View, typename Pred>
+filter_view<View, Pred> operator | (View view, filter_adaptor<Pred> a) { return filter_view<View, Pred>(view, a.pred); }
+template <typename View, typename F>
+transform_view<View, F> operator | (View view, transform_adaptor<F> a) { return transform_view<View, F>(view, a.f); }
+template <typename View>
+take_view<View> operator | (View view, take_adaptor a) { return take_view<View>(view, a.count); }
+template <typename View>
+drop_view<View> operator | (View view, drop_adaptor a) { return drop_view<View>(view, a.count); }
+
+/* Оператори | для самого списку (список не копіюється, а обгортається в range_view).
+Зворотний порядок потребує двонаправленого обходу, тому reverse застосовується лише
+до списку, і вже потім - інші адаптери */
+template <typename T, typename Pred>
+auto operator | (const Linked2List<T>& list, filter_adaptor<Pred> a) { return all(list) | a; }
+template <typename T, typename F>
+auto operator | (const Linked2List<T>& list, transform_adaptor<F> a) { return all(list) | a; }
+template <typename T>
+auto operator | (const Linked2List<T>& list, take_adaptor a) { return all(list) | a; }
+template <typename T>
+auto operator | (const Linked2List<T>& list, drop_adaptor a) { return all(list) | a; }
+template <typename T>
+range_view<typename Linked2List<T>::reverse_iterator> operator | (const Linked2List<T>& list, reverse_adaptor) {
+    return reversed(list);
+}
+
+// Функція, що матеріалізує подання в новий список (лише тут елементи копіюються)
+template <typename View>
+auto to_list(const View& view) {
+    typedef typename std::decay<decltype(*view.begin())>::type Value;
+    Linked2List<Value> result;
+    auto last = view.end();
+    for (auto it = view.begin(); it != last; ++it)
+        result.push_back(*it);
+    return result;
+}
+
+} // namespace views
+
+
+/////////////////////////// ДОПОМІЖНІ ФУНКЦІЇ ///////////////////////////////
+
+/* Функція перевірки двох рядків (const char* a, const char* b) 
+на рівність (повертає true, якщо рівні та false, якщо ні) */
+bool strcmp_equal(const char* a, const char* b) {
+    size_t i = 0;
+    while (a[i] != '\0' && b[i] != '\0') {
+        if (a[i] != b[i]) return false;
+        ++i;
+    }
+    return a[i] == b[i];
+}
+// Процедура копіювання рядка (const char* src) у масив (char* dest)
+void strcpy_custom(char* dest, const char* src) {
+    size_t i = 0;
+    while (src[i] != '\0') {
+        dest[i] = src[i];
+        ++i;
+    }
+    dest[i] = '\0';
+}
+/* Функція для визначення довжини рядка (const char* str)
+Повертає довжину типу size_t */
+size_t strlen_custom(const char* str) {
+    size_t len = 0;
+    while (str[len] != '\0') ++len;
+    return len;
+}
+
+/////////////////////////// СТРУКТУРА ПІСНІ ///////////////////////////////
+
+struct Song {
+    char* name; // Назва пісні
+    char* author; // Ім'я автора
+    int duration; // Довжина пісні в секундах
+    t_hook queue_hook; // Гачок черги відтворення (копії пісні в чергу не потрапляють)
+    // Конструктор за замовчуванням
+    Song() : name(nullptr), author(nullptr), duration(0) {
+        // Створюємо масиви типу char розмірності 1
+        name = new char[1];
+        name[0] = '\0';
+        author = new char[1];
+        author[0] = '\0';
+    }
+    // Конструктор з параметром
+    Song(const char* n, const char* a, int d) : duration(d) {
+        // визначаємо довжину рядка
+        size_t len = strlen_custom(n) + 1;
+        // виділяємо пам'ять під масиви та заповнюємо їх значеннями
+        name = new char[len];
+        strcpy_custom(name, n);
+        // так само для другого рядка
+        len = strlen_custom(a) + 1;
+        author = new char[len];
+        strcpy_custom(author, a);
+    }
+    
+    // Конструктор копіювання
+    Song(const Song& other) : duration(other.duration) {
+        // визначаємо довжину рядка
+        size_t len = strlen_custom(other.name) + 1;
+        // виділяємо пам'ять під масиви та заповнюємо їх значеннями
+        name = new char[len];
+        strcpy_custom(name, other.name);
+        // так само для другого рядка
+        len = strlen_custom(other.author) + 1;
+        author = new char[len];
+        strcpy_custom(author, other.author);
+    }
+    // Перевантаження оператору присвоєння, повертає посилання (Song&) на поточний об'єкт
+    Song& operator=(const Song& other) {
+        if (this != &other) {
+            delete[] name;
+            delete[] author;
+            // визначаємо довжину рядка
+            size_t len = strlen_custom(other.name) + 1;
+            // виділяємо пам'ять під масиви та заповнюємо їх значеннями
+            name = new char[len];
+            strcpy_custom(name, other.name);
+            // так само для другого рядка
+            len = strlen_custom(other.author) + 1;
+            author = new char[len];
+            strcpy_custom(author, other.author);
+            duration = other.duration;
+        }
+        return *this;
+    }
+    /* Перевантаження оператору == (порівняння на рівність всіх полів двох об'єктів типу Song), 
+    повертає true, в разі рівності і false, в разі нерівності */
+    bool operator==(const Song& other) const {
+        return strcmp_equal(name, other.name) && strcmp_equal(author, other.author) && duration == other.duration;
+    }
+    /* Перевантаження оператору != (порівняння на нерівність полів двох об'єктів типу Song), 
+    повертає true, в разі нерівності хоч одного поля, false в разі повної рівності */
+    bool operator!=(const Song& other) const {
+        return !(*this == other);
+    }
+    /* Перевантаження оператору < (порівняння часу), в разі якщо в полі значення duration поточного об'єкту
+    менше, ніж у переданого, повертає true, в протилежному випадку - false*/
+    bool operator<(const Song& other) const {
+        return duration < other.duration;
+    }
+    /* Перевантаження оператору > (порівняння часу), в разі якщо в полі значення duration поточного об'єкту
+    більше, ніж у переданого, повертає true, в протилежному випадку - false*/
+    bool operator>(const Song& other) const {
+        return duration > other.duration;
+    }
+    // Перевантаження оператору <= (менше за часом або рівні) логічне об'єднання вже реалізованих (== та <)
+    bool operator<=(const Song& other) const {
+        return (*this < other) || (*this == other);
+    }
+    // Перевантаження оператору >= (більше за часом або рівні) логічне об'єднання вже реалізованих (== та >)
+    bool operator>=(const Song& other) const {
+        return (*this > other) || (*this == other);
+    }
+    // Деструктор
+    ~Song() {
+        delete[] name;
+        delete[] author;
+    }
+};
+
+/////////////////////////// УНАРНІ ПРЕДИКАТИ ТА КОМПАРАТОРИ ///////////////////////////////
+
+// Компаратор, аргументами є два посилання(Song&) на об'єкти а та b
+// Повертає true, якщо довжина пісні a менша або дорівнює довжині пісні b 
+// false в протилежному випадку
+bool compare_by_duration(Song& a, Song& b) {
+    return a.duration <= b.duration;
+}
+// Строгі компаратори для top_k / select_nth: true, якщо пісня a коротша (довша) за пісню b
+bool is_shorter(Song& a, Song& b) {
+    return a.duration < b.duration;
+}
+bool is_longer(Song& a, Song& b) {
+    return a.duration > b.duration;
+}
+// Функція-ключ для sort_by_key, аргументом є посилання(Song&) на об'єкт s, повертає довжину пісні
+int song_duration(Song& s) {
+    return s.duration;
+}
+// Унарний предикат, аргументом є посилання(Song&) на об'єкт а
+// Повертає true, в разі якщо довжина пісні більша за 5 хв (300 с), false в протилежному випадку
+bool is_long_song(Song& s) {
+    return s.duration > 300; // більше 5 хвилин
+}
+// Унарний предикат, аргументом є посилання(Song&) на об'єкт а
+// Повертає true, в разі якщо довжина пісні менша за 3 хв (180 с), false в протилежному випадку
+bool is_short_song(Song& s) {
+    return s.duration < 180; // менше 3 хвилин
+}
+
+/////////////////////////// КАТАЛОГ ПІСЕНЬ ///////////////////////////////
+
+/* Легкий дескриптор пісні в каталозі SongCatalog. Плейлисти Linked2List<SongHandle> тримають
+лише дескриптори, тому копіювання, обмін та злиття плейлистів переносять 8 байтів на пісню
+замість рядків, а порівняння пісень на рівність - це порівняння номерів */
+struct SongHandle {
+    unsigned id; // Номер пісні в каталозі (стабільний, поки існує каталог)
+    int duration; // Тривалість (незмінна, тому зберігається тут, щоб sort/merge не зверталися до каталогу)
+    // Перевантаження оператору == (та сама пісня каталогу)
+    bool operator==(const SongHandle& other) const {
+        return id == other.id;
+    }
+    // Перевантаження оператору !=
+    bool operator!=(const SongHandle& other) const {
+        return id != other.id;
+    }
+    // Перевантаження оператору < (порівняння часу, як у Song, для merge)
+    bool operator<(const SongHandle& other) const {
+        return duration < other.duration;
+    }
+};
+// Функція-ключ для sort_by_key, повертає довжину пісні за дескриптором
+int handle_duration(SongHandle& h) {
+    return h.duration;
+}
+
+/* Спільний каталог пісень. Кожна пісня зберігається один раз: назви - підряд в одному
+буфері, автори - інтерновані (кожне ім'я зберігається один раз, пісня тримає лише його номер).
+Запис пісні займає 12 байтів плюс її назва */
+class SongCatalog {
+  public:
+    // Метод, що додає пісню в каталог і повертає її дескриптор
+    SongHandle add(const char* name, const char* author, int duration);
+    // Метод, що додає в каталог копію пісні (const Song& s)
+    SongHandle add(const Song& s);
+    // Метод, що повертає дескриптор пісні за її номером у каталозі
+    SongHandle handle(unsigned id) const;
+    // Метод, що повертає назву пісні (вказівник дійсний до наступного add)
+    const char* name(SongHandle h) const;
+    // Метод, що повертає автора пісні (вказівник дійсний, поки існує каталог)
+    const char* author(SongHandle h) const;
+    // Метод, що повертає номер інтернованого автора (однаковий для всіх пісень автора)
+    unsigned author_id(SongHandle h) const;
+    // Метод, що створює окрему копію пісні (Song) за дескриптором
+    Song to_song(SongHandle h) const;
+    // Метод, що повертає кількість пісень у каталозі
+    size_t size() const;
+    // Метод, що повертає кількість різних авторів
+    size_t author_count() const;
+    // Метод, що оцінює пам'ять, зайняту каталогом (у байтах, без службових даних malloc)
+    size_t memory_bytes() const;
+  private:
+    // Запис пісні в каталозі
+    struct Record {
+        unsigned name_offset; // Зміщення назви в буфері names
+        unsigned author; // Номер автора в authors
+        int duration; // Тривалість у секундах
+    };
+    std::vector<Record> songs; // Пісні за номером
+    std::string names; // Назви всіх пісень підряд, кожна завершується '\0'
+    std::deque<std::string> authors; // Інтерновані автори (deque не переміщує вже додані рядки)
+    std::unordered_map<std::string_view, unsigned> author_ids; // Автор -> номер (ключі вказують в authors)
+};
+
+/* *** РЕАЛІЗАЦІЯ МЕТОДІВ КАТАЛОГУ ПІСЕНЬ (SongCatalog) *** */
+
+SongHandle SongCatalog::add(const char* name, const char* author, int duration) {
+    auto found = author_ids.find(std::string_view(author));
+    unsigned author_no;
+    if (found != author_ids.end()) {
+        author_no = found -> second;
+    } else {
+        author_no = (unsigned)authors.size();
+        authors.push_back(author);
+        author_ids.emplace(std::string_view(authors.back()), author_no);
+    }
+    Record record = { (unsigned)names.size(), author_no, duration };
+    names.append(name);
+    names += '\0';
+    songs.push_back(record);
+    return handle((unsigned)(songs.size() - 1));
+}
+
+SongHandle SongCatalog::add(const Song& s) {
+    return add(s.name, s.author, s.duration);
+}
+
+SongHandle SongCatalog::handle(unsigned id) const {
+    return SongHandle{ id, songs[id].duration };
+}
+
+const char* SongCatalog::name(SongHandle h) const {
+    return names.c_str() + songs[h.id].name_offset;
+}
+
+const char* SongCatalog::author(SongHandle h) const {
+    return authors[songs[h.id].author].c_str();
+}
+
+unsigned SongCatalog::author_id(SongHandle h) const {
+    return songs[h.id].author;
+}
+
+Song SongCatalog::to_song(SongHandle h) const {
+    return Song(name(h), author(h), songs[h.id].duration);
+}
+
+size_t SongCatalog::size() const {
+    return songs.size();
+}
+
+size_t SongCatalog::author_count() const {
+    return authors.size();
+}
+
+size_t SongCatalog::memory_bytes() const {
+    size_t bytes = songs.capacity() * sizeof(Record) + names.capacity();
+    for (const std::string& a : authors)
+        bytes += sizeof(std::string) + (a.size() > 15 ? a.capacity() + 1 : 0);
+    // Таблиця інтернування: масив кошиків та вузли (ключ, номер, вказівник на наступний, хеш)
+    bytes += author_ids.bucket_count() * sizeof(void*)
+             + author_ids.size() * (sizeof(std::string_view) + 2 * sizeof(void*) + sizeof(size_t));
+    return bytes;
+}
+
+
+/////////////////////////// ІНДЕКС ПОШУКУ ПІСЕНЬ ///////////////////////////////
+
+/* Індекс для пошуку пісень за початком або фрагментом назви чи автора без повного проходу
+по списку. Ведеться поруч зі списком Linked2List<Song> і оновлюється інкрементально
+(insert/erase на кожну вставку/видалення вузла). Пошук нечутливий до регістру латиниці
+та кирилиці. Результати - ітератори на вузли списку, не більше k штук.
+    - префіксний пошук: стиснуте префіксне дерево (radix tree) за назвами та авторами,
+      результати повертаються в алфавітному порядку ключів;
+    - пошук фрагмента: списки входжень триграм (трійок байтів), кандидати з найкоротшого
+      списку перевіряються на справжнє входження, результати - в порядку додавання.
+      Запити коротші за 3 байти (1-2 латинські літери або одна кирилична - вона займає
+      2 байти UTF-8) триграм не мають, тому для них є окремі списки входжень окремих
+      символів і пар символів (за кодом символу Unicode, а не за байтами).
+Видалені записи зі списків входжень прибираються ліниво: коли їх стає більше за живі,
+індекс перебудовується, тому видалення коштує O(1) в середньому */
+class SongIndex {
+  public:
+    typedef Linked2List<Song>::iterator iterator;
+    // Конструктор з параметром (enabled = false - вимкнений індекс, що нічого не зберігає)
+    SongIndex(bool enabled = true);
+    // Копіювання заборонене (індекс прив'язаний до вузлів конкретного списку)
+    SongIndex(const SongIndex& other) = delete;
+    SongIndex& operator=(const SongIndex& other) = delete;
+    // Деструктор
+    ~SongIndex();
+    // Метод, що додає в індекс пісню з вузла, на який вказує ітератор
+    void insert(iterator it);
+    // Метод, що видаляє з індексу пісню з вузла (викликати ДО видалення вузла зі списку)
+    void erase(iterator it);
+    // Метод, що очищає індекс
+    void clear();
+    // Метод, що будує індекс заново за всіма вузлами списку
+    void rebuild(const Linked2List<Song>& list);
+    // Метод Swap (для обміну вмістом двох індексів разом з обміном списків)
+    void swap(SongIndex& other) noexcept;
+    // Метод, що повертає кількість проіндексованих пісень
+    size_t size() const;
+    // Метод, що шукає до k пісень, назва або автор яких починається з query
+    std::vector<iterator> find_prefix(const char* query, size_t k) const;
+    // Метод, що шукає до k пісень, назва або автор яких містить фрагмент query
+    std::vector<iterator> find_substring(const char* query, size_t k) const;
+  private:
+    // Запис про проіндексовану пісню
+    struct Entry {
+        iterator it; // Вузол списку
+        std::string name; // Нормалізована назва
+        std::string author; // Нормалізований автор
+        bool live; // false, якщо запис видалено
+    };
+    // Вузол стиснутого префіксного дерева
+    struct TrieNode {
+        std::string label; // Фрагмент ключа на ребрі до цього вузла
+        std::vector<TrieNode*> children; // Нащадки, впорядковані за першим байтом label
+        std::vector<unsigned> ids; // Записи, ключ яких закінчується в цьому вузлі
+    };
+    TrieNode* root; // Корінь дерева (порожня мітка)
+    std::vector<Entry> entries; // Записи за номером
+    std::unordered_map<const Song*, unsigned> id_of; // Номер запису за адресою пісні у вузлі
+    std::unordered_map<unsigned, std::vector<unsigned>> postings; // Триграма -> номери записів
+    std::unordered_map<unsigned long long, std::vector<unsigned>> short_postings; // Символ або пара -> номери записів
+    size_t dead; // Кількість видалених записів, що ще лишаються у списках триграм
+    bool enabled; // false - індекс вимкнено (дзеркальна сесія журналу нічого не шукає)
+
+    static std::string normalize(const char* str);
+    static unsigned trigram(const std::string& str, size_t pos);
+    static size_t code_point(const std::string& str, size_t pos, unsigned& cp);
+    static void short_grams(const std::string& str, std::vector<unsigned long long>& out);
+    static size_t child_position(const TrieNode* node, unsigned char c);
+    static void destroy(TrieNode* node);
+    void trie_insert(const std::string& key, unsigned id);
+    void trie_erase(TrieNode* node, const std::string& key, size_t pos, unsigned id);
+    void add_postings(unsigned id);
+};
+
+/* *** РЕАЛІЗАЦІЯ МЕТОДІВ ІНДЕКСУ ПОШУКУ (SongIndex) *** */
+
+SongIndex::SongIndex(bool enabled) : root(new TrieNode), dead(0), enabled(enabled) {}
+
+SongIndex::~SongIndex() {
+    destroy(root);
+}
+
+/* Нормалізація ключа: ASCII та кирилиця UTF-8 (включно з Є, І, Ї, Ґ) переводяться в нижній
+регістр, решта байтів лишається без змін */
+std::string SongIndex::normalize(const char* str) {
+    std::string out;
+    out.reserve(strlen_custom(str));
+    for (size_t i = 0; str[i] != '\0'; ++i) {
+        unsigned char c = (unsigned char)str[i];
+        unsigned char n = (unsigned char)str[i + 1];
+        if (c >= 'A' && c <= 'Z') {
+            out += char(c + 32);
+        } else if (c == 0xD0 && n >= 0x80 && n <= 0xAF) {
+            if (n >= 0x90 && n <= 0x9F) { // А..П -> а..п
+                out += char(0xD0);
+                out += char(n + 0x20);
+            } else if (n >= 0xA0) { // Р..Я -> р..я
+                out += char(0xD1);
+                out += char(n - 0x20);
+            } else { // Ѐ..Џ (Є, І, Ї) -> ѐ..џ
+                out += char(0xD1);
+                out += char(n + 0x10);
+            }
+            ++i;
+        } else if (c == 0xD2 && n == 0x90) { // Ґ -> ґ
+            out += char(0xD2);
+            out += char(0x91);
+            ++i;
+        } else {
+            out += char(c);
+        }
+    }
+    return out;
+}
+
+unsigned SongIndex::trigram(const std::string& str, size_t pos) {
+    return ((unsigned char)str[pos] << 16) | ((unsigned char)str[pos + 1] << 8) | (unsigned char)str[pos + 2];
+}
+
+// Метод, що повертає позицію, на якій стоїть (або мав би стояти) нащадок з першим байтом c
+size_t SongIndex::child_position(const TrieNode* node, unsigned char c) {
+    auto pos = std::lower_bound(node -> children.begin(), node -> children.end(), c,
+        [](const TrieNode* child, unsigned char value) { return (unsigned char)child -> label[0] < value; });
+    return pos - node -> children.begin();
+}
+
+void SongIndex::destroy(TrieNode* node) {
+    for (TrieNode* child : node -> children)
+        destroy(child);
+    delete node;
+}
+
+// Вставка ключа в дерево; якщо ключ розходиться з міткою ребра посередині - ребро розділяється
+void SongIndex::trie_insert(const std::string& key, unsigned id) {
+    TrieNode* node = root;
+    size_t pos = 0;
+    while (pos < key.size()) {
+        size_t ci = child_position(node, key[pos]);
+        if (ci == node -> children.size() || node -> children[ci] -> label[0] != key[pos]) {
+            TrieNode* leaf = new TrieNode;
+            leaf -> label = key.substr(pos);
+            leaf -> ids.push_back(id);
+            node -> children.insert(node -> children.begin() + ci, leaf);
+            return;
+        }
+        TrieNode* child = node -> children[ci];
+        size_t common = 1;
+        while (common < child -> label.size() && pos + common < key.size()
+               && child -> label[common] == key[pos + common])
+            ++common;
+        if (common < child -> label.size()) {
+            TrieNode* middle = new TrieNode;
+            middle -> label = child -> label.substr(0, common);
+            child -> label.erase(0, common);
+            middle -> children.push_back(child);
+            node -> children[ci] = middle;
+            child = middle;
+        }
+        node = child;
+        pos += common;
+    }
+    node -> ids.push_back(id);
+}
+
+/* Видалення ключа з дерева. Після повернення з рекурсії порожній лист видаляється, а вузол
+без записів з єдиним нащадком зливається з ним, тому дерево лишається стиснутим */
+void SongIndex::trie_erase(TrieNode* node, const std::string& key, size_t pos, unsigned id) {
+    if (pos == key.size()) {
+        for (size_t i = 0; i < node -> ids.size(); ++i) {
+            if (node -> ids[i] == id) {
+                node -> ids.erase(node -> ids.begin() + i);
+                break;
+            }
+        }
+        return;
+    }
+    size_t ci = child_position(node, key[pos]);
+    if (ci == node -> children.size()) return;
+    TrieNode* child = node -> children[ci];
+    if (key.compare(pos, child -> label.size(), child -> label) != 0) return;
+    trie_erase(child, key, pos + child -> label.size(), id);
+    if (!child -> ids.empty()) return;
+    if (child -> children.empty()) {
+        delete child;
+        node -> children.erase(node -> children.begin() + ci);
+    } else if (child -> children.size() == 1) {
+        TrieNode* grandchild = child -> children[0];
+        grandchild -> label = child -> label + grandchild -> label;
+        delete child;
+        node -> children[ci] = grandchild;
+    }
+}
+
+/* Метод, що читає символ UTF-8 з позиції pos: записує його код у cp і повертає довжину в байтах.
+Некоректний байт вважається окремим символом з кодом поза межами Unicode (0x110000 + байт) */
+size_t SongIndex::code_point(const std::string& str, size_t pos, unsigned& cp) {
+    unsigned char c = str[pos];
+    size_t len = c < 0x80 ? 1 : (c >> 5) == 0x6 ? 2 : (c >> 4) == 0xE ? 3 : (c >> 3) == 0x1E ? 4 : 0;
+    if (len == 0 || pos + len > str.size()) {
+        cp = 0x110000 + c;
+        return 1;
+    }
+    cp = len == 1 ? c : c & (0x7F >> len);
+    for (size_t i = 1; i < len; ++i) {
+        unsigned char cont = str[pos + i];
+        if ((cont >> 6) != 0x2) {
+            cp = 0x110000 + c;
+            return 1;
+        }
+        cp = (cp << 6) | (cont & 0x3F);
+    }
+    return len;
+}
+
+/* Метод, що дописує в out ключі всіх символів (код + 1) і пар сусідніх символів
+((код1 + 1) << 22 | (код2 + 1)) рядка. Ключі символів менші за 2^22, ключі пар - не менші */
+void SongIndex::short_grams(const std::string& str, std::vector<unsigned long long>& out) {
+    unsigned long long prev = 0;
+    for (size_t pos = 0; pos < str.size(); ) {
+        unsigned cp;
+        pos += code_point(str, pos, cp);
+        unsigned long long key = cp + 1ULL;
+        out.push_back(key);
+        if (prev != 0) out.push_back((prev << 22) | key);
+        prev = key;
+    }
+}
+
+// Додавання запису у списки входжень всіх його різних триграм, символів і пар символів (назви та автора)
+void SongIndex::add_postings(unsigned id) {
+    const Entry& e = entries[id];
+    std::vector<unsigned> grams;
+    for (size_t i = 0; i + 3 <= e.name.size(); ++i) grams.push_back(trigram(e.name, i));
+    for (size_t i = 0; i + 3 <= e.author.size(); ++i) grams.push_back(trigram(e.author, i));
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+    for (unsigned g : grams)
+        postings[g].push_back(id);
+    std::vector<unsigned long long> short_keys;
+    short_grams(e.name, short_keys);
+    short_grams(e.author, short_keys);
+    std::sort(short_keys.begin(), short_keys.end());
+    short_keys.erase(std::unique(short_keys.begin(), short_keys.end()), short_keys.end());
+    for (unsigned long long key : short_keys)
+        short_postings[key].push_back(id);
+}
+
+// Метод, що додає в індекс пісню з вузла, на який вказує ітератор
+void SongIndex::insert(iterator it) {
+    if (!enabled) return;
+    unsigned id = (unsigned)entries.size();
+    Song& s = *it;
+    entries.push_back(Entry{it, normalize(s.name), normalize(s.author), true});
+    id_of[&s] = id;
+    trie_insert(entries[id].name, id);
+    if (entries[id].author != entries[id].name)
+        trie_insert(entries[id].author, id);
+    add_postings(id);
+}
+
+// Метод, що видаляє з індексу пісню з вузла (викликати ДО видалення вузла зі списку)
+void SongIndex::erase(iterator it) {
+    auto found = id_of.find(&*it);
+    if (found == id_of.end()) return;
+    unsigned id = found -> second;
+    id_of.erase(found);
+    Entry& e = entries[id];
+    trie_erase(root, e.name, 0, id);
+    if (e.author != e.name)
+        trie_erase(root, e.author, 0, id);
+    e.live = false;
+    e.name = std::string();
+    e.author = std::string();
+    ++dead;
+    // Коли видалених записів більше, ніж живих, перебудовуємо індекс з живих записів
+    if (dead > 1024 && dead > id_of.size()) {
+        std::vector<iterator> live;
+        live.reserve(id_of.size());
+        for (const Entry& rest : entries)
+            if (rest.live) live.push_back(rest.it);
+        clear();
+        for (const iterator& rest : live)
+            insert(rest);
+    }
+}
+
+// Метод, що очищає індекс
+void SongIndex::clear() {
+    destroy(root);
+    root = new TrieNode;
+    entries.clear();
+    id_of.clear();
+    postings.clear();
+    short_postings.clear();
+    dead = 0;
+}
+
+// Метод, що будує індекс заново за всіма вузлами списку
+void SongIndex::rebuild(const Linked2List<Song>& list) {
+    clear();
+    if (!enabled) return;
+    entries.reserve(list.size());
+    size_t n = 0;
+    for (auto it = list.begin(); n < list.size(); ++it, ++n)
+        insert(it);
+}
+
+// Метод Swap (для обміну вмістом двох індексів)
+void SongIndex::swap(SongIndex& other) noexcept {
+    std::swap(root, other.root);
+    entries.swap(other.entries);
+    id_of.swap(other.id_of);
+    postings.swap(other.postings);
+    short_postings.swap(other.short_postings);
+    std::swap(dead, other.dead);
+    std::swap(enabled, other.enabled);
+}
+
+// Метод, що повертає кількість проіндексованих пісень
+size_t SongIndex::size() const {
+    return id_of.size();
+}
+
+/* Префіксний пошук: спуск по дереву за запитом, після чого обхід піддерева в глибину
+зупиняється, щойно набрано k результатів. Кожен лист стиснутого дерева містить хоча б
+один запис, тому обхід відвідує O(k) вузлів незалежно від розміру каталогу */
+std::vector<SongIndex::iterator> SongIndex::find_prefix(const char* query, size_t k) const {
+    std::vector<iterator> result;
+    std::string q = normalize(query);
+    if (k == 0) return result;
+    const TrieNode* node = root;
+    size_t pos = 0;
+    while (pos < q.size()) {
+        size_t ci = child_position(node, q[pos]);
+        if (ci == node -> children.size() || node -> children[ci] -> label[0] != q[pos]) return result;
+        const TrieNode* child = node -> children[ci];
+        size_t len = child -> label.size() < q.size() - pos ? child -> label.size() : q.size() - pos;
+        if (child -> label.compare(0, len, q, pos, len) != 0) return result;
+        pos += len;
+        node = child;
+    }
+    std::unordered_set<unsigned> seen;
+    std::vector<const TrieNode*> stack(1, node);
+    while (!stack.empty() && result.size() < k) {
+        const TrieNode* cur = stack.back();
+        stack.pop_back();
+        for (size_t i = 0; i < cur -> ids.size() && result.size() < k; ++i)
+            if (seen.insert(cur -> ids[i]).second)
+                result.push_back(entries[cur -> ids[i]].it);
+        for (size_t i = cur -> children.size(); i > 0; --i)
+            stack.push_back(cur -> children[i - 1]);
+    }
+    return result;
+}
+
+/* Пошук фрагмента: з триграм запиту обирається та, що має найкоротший список входжень,
+і лише його записи перевіряються на справжнє входження фрагмента. Запити коротші за
+3 байти (не більше двох символів) беруть список входжень свого символу або пари символів */
+std::vector<SongIndex::iterator> SongIndex::find_substring(const char* query, size_t k) const {
+    std::vector<iterator> result;
+    std::string q = normalize(query);
+    if (k == 0 || q.empty()) return result;
+    const std::vector<unsigned>* shortest = nullptr;
+    if (q.size() < 3) {
+        std::vector<unsigned long long> keys;
+        short_grams(q, keys); // один символ - один ключ, два символи - два ключі символів і ключ пари
+        auto found = short_postings.find(keys.back());
+        if (found == short_postings.end()) return result;
+        shortest = &found -> second;
+    }
+    for (size_t i = 0; i + 3 <= q.size(); ++i) {
+        auto found = postings.find(trigram(q, i));
+        if (found == postings.end()) return result; // триграми немає в жодному записі
+        if (shortest == nullptr || found -> second.size() < shortest -> size())
+            shortest = &found -> second;
+    }
+    for (size_t i = 0; i < shortest -> size() && result.size() < k; ++i) {
+        const Entry& e = entries[(*shortest)[i]];
+        if (e.live && (e.name.find(q) != std::string::npos || e.author.find(q) != std::string::npos))
+            result.push_back(e.it);
+    }
+    return result;
+}
+
+/////////////////////////// ЖУРНАЛ ОПЕРАЦІЙ ///////////////////////////////
+
+/* Журнал операцій - бінарний файл, в кінець якого лише дописуються зміни плейлистів.
+Запис: [u32 довжина даних][u32 контрольна сума FNV-1a][дані], де дані - це
+[u64 номер запису (LSN)][u8 тип операції][аргументи операції].
+Викликач лише кладе запис у чергу в пам'яті, а на диск їх пише окремий потік: все, що
+накопичилося за час попереднього запису, пишеться однією групою (group commit), а fsync
+викликається не частіше, ніж раз на fsync_every записів.
+Щоб журнал не ріс безмежно, кожні checkpoint_every записів зберігається знімок стану
+(файл <prefix>.snapshot, записується в тимчасовий файл і атомарно перейменовується),
+після чого журнал обнуляється. Знімок серіалізує не викликач, а потік запису: він
+повторює записані операції над власною дзеркальною копією стану (set_mirror), тож
+редагування ніколи не чекає на O(n) серіалізацію. Під час відновлення читається знімок,
+а потім записи журналу з LSN, більшим за LSN знімка; обірваний або пошкоджений хвіст
+журналу відкидається. Якщо запис у файл не вдався, журнал переходить у стан помилки:
+подальші записи відкидаються, а flush() та failed() про це повідомляють */
+
+// Типи операцій, що записуються в журнал
+enum JournalOp {
+    JOP_ADD_BACK = 1, JOP_ADD_FRONT, JOP_POP_BACK, JOP_POP_FRONT, JOP_REMOVE_LONG,
+    JOP_SORT, JOP_CLEAR, JOP_SWAP, JOP_MERGE, JOP_SHUFFLE
+};
+
+// Налаштування журналу
+struct JournalOptions {
+    size_t fsync_every; // fsync після кожних N записів (0 - fsync лише під час знімків і закриття)
+    size_t checkpoint_every; // Знімок стану після кожних N записів (0 - без знімків)
+};
+
+/* Результат відновлення. Пошкоджений знімок або пропуск у номерах записів означає, що частину
+стану втрачено: такий журнал не відновлюється "як вийде", а програма відмовляється працювати,
+доки файли не перевірить людина */
+enum JournalRecovery {
+    JR_EMPTY, // Відновлювати нічого (журналу та знімка немає або вони порожні)
+    JR_RECOVERED, // Стан відновлено
+    JR_BAD_SNAPSHOT, // Файл знімка є, але пошкоджений (заголовок або контрольна сума)
+    JR_LSN_GAP, // Записи журналу не продовжують знімок (бракує записів між ними)
+    JR_TRUNCATE_FAILED // Не вдалося відрізати пошкоджений хвіст журналу
+};
+
+// Запис журналу, прочитаний під час відновлення
+struct JournalRecord {
+    unsigned long long lsn; // Номер запису
+    JournalOp op; // Тип операції
+    Song song; // Пісня (для JOP_ADD_BACK та JOP_ADD_FRONT)
+    unsigned long long arg; // Числовий аргумент (seed для JOP_SHUFFLE)
+};
+
+// Функція, що скидає буфери файлу (FILE* f) на диск, повертає false у разі помилки
+bool sync_file(FILE* f) {
+    if (std::fflush(f) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(f)) == 0;
+#else
+    return fsync(fileno(f)) == 0;
+#endif
+}
+
+/* Функція, що скидає на диск каталог, в якому лежить файл (const std::string& path):
+без цього перейменування файлу може не пережити збій, навіть якщо сам файл вже на диску */
+bool sync_parent_directory(const std::string& path) {
+#ifdef _WIN32
+    (void)path; // каталог не відкрити через CRT, а NTFS і так журналює метадані
+    return true;
+#else
+    std::string dir = std::filesystem::path(path).parent_path().string();
+    if (dir.empty()) dir = ".";
+    int fd = open(dir.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    bool ok = fsync(fd) == 0;
+    close(fd);
+    return ok;
+#endif
+}
+
+class OperationJournal {
+  public:
+    // Конструктор з параметрами (prefix - шлях без розширення для файлів журналу та знімка)
+    OperationJournal(const char* prefix, JournalOptions options);
+    OperationJournal(const OperationJournal& other) = delete;
+    OperationJournal& operator=(const OperationJournal& other) = delete;
+    // Деструктор (дописує чергу, робить fsync та зупиняє потік запису)
+    ~OperationJournal();
+    /* Метод відновлення, викликається до start(). on_snapshot(const char* data, size_t size)
+    отримує вміст знімка, on_record(const JournalRecord&) - кожен запис після знімка.
+    Будь-який результат, крім JR_EMPTY та JR_RECOVERED, означає, що продовжувати не можна */
+    template <typename SnapshotVisitor, typename RecordVisitor>
+    JournalRecovery recover(SnapshotVisitor on_snapshot, RecordVisitor on_record);
+    // Метод, що відкриває журнал для дописування і запускає потік запису
+    bool start();
+    /* Метод, що задає дзеркальну копію стану для знімків, викликається до start(). apply
+    повторює над копією записаний запис, serialize - серіалізує копію. Обидві функції
+    викликаються лише потоком запису; без дзеркала знімки не робляться */
+    void set_mirror(std::function<void(const JournalRecord&)> apply, std::function<std::string()> serialize);
+    // Метод, що додає запис про операцію в чергу (не чекає на диск)
+    void append(JournalOp op, const Song* song, unsigned long long arg);
+    /* Метод, що чекає, поки всі додані записи будуть передані у файл (fsync - за налаштуваннями).
+    Повертає false, якщо журнал у стані помилки і частину записів не збережено */
+    bool flush();
+    // Метод, що перевіряє чи не стався збій запису в журнал
+    bool failed() const;
+
+    // Допоміжні методи серіалізації
+    static void put_u32(std::string& out, unsigned value);
+    static void put_u64(std::string& out, unsigned long long value);
+    static void put_song(std::string& out, const Song& s);
+    static bool get_u32(const char*& p, const char* end, unsigned& value);
+    static bool get_u64(const char*& p, const char* end, unsigned long long& value);
+    static bool get_song(const char*& p, const char* end, Song& s);
+    // Метод, що читає з p один запис журналу (з перевіркою контрольної суми) і зсуває p за нього
+    static bool decode_record(const char*& p, const char* end, JournalRecord& record);
+  private:
+    std::string journal_path; // Шлях до файлу журналу
+    std::string snapshot_path; // Шлях до файлу знімка
+    JournalOptions options; // Налаштування
+    FILE* file; // Відкритий для дописування журнал
+    std::thread writer; // Потік запису
+    mutable std::mutex mutex; // Захищає всі поля нижче
+    std::condition_variable wake_writer; // Сигнал потоку запису про нову роботу
+    std::condition_variable written; // Сигнал про те, що записи дійшли до файлу
+    std::string pending; // Байти записів, що чекають на запис (наступна група)
+    size_t pending_records; // Кількість записів у pending
+    unsigned long long next_lsn; // LSN наступного запису
+    unsigned long long written_lsn; // LSN останнього запису, який вже у файлі
+    bool stopping; // Прапорець зупинки потоку запису
+    bool write_failed; // Прапорець збою запису (після нього записи у файл не пишуться)
+    // Поля нижче використовує лише потік запису
+    std::function<void(const JournalRecord&)> mirror_apply; // Повторення запису над дзеркалом
+    std::function<std::string()> mirror_serialize; // Серіалізація дзеркала для знімка
+
+    static unsigned checksum(const char* data, size_t size);
+    void writer_loop();
+    void write_snapshot(const std::string& data, unsigned long long lsn);
+};
+
+/* *** РЕАЛІЗАЦІЯ МЕТОДІВ ЖУРНАЛУ ОПЕРАЦІЙ (OperationJournal) *** */
+
+OperationJournal::OperationJournal(const char* prefix, JournalOptions options)
+    : journal_path(std::string(prefix) + ".journal"), snapshot_path(std::string(prefix) + ".snapshot"),
+      options(options), file(nullptr), pending_records(0), next_lsn(1), written_lsn(0), stopping(false),
+      write_failed(false) {}
+
+OperationJournal::~OperationJournal() {
+    if (writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake_writer.notify_one();
+        writer.join();
+    }
+    if (file != nullptr) std::fclose(file);
+}
+
+void OperationJournal::put_u32(std::string& out, unsigned value) {
+    for (int i = 0; i < 4; ++i) out += char((value >> (8 * i)) & 0xFF);
+}
+
+void OperationJournal::put_u64(std::string& out, unsigned long long value) {
+    for (int i = 0; i < 8; ++i) out += char((value >> (8 * i)) & 0xFF);
+}
+
+void OperationJournal::put_song(std::string& out, const Song& s) {
+    unsigned len = (unsigned)strlen_custom(s.name);
+    put_u32(out, len);
+    out.append(s.name, len);
+    len = (unsigned)strlen_custom(s.author);
+    put_u32(out, len);
+    out.append(s.author, len);
+    put_u32(out, (unsigned)s.duration);
+}
+
+bool OperationJournal::get_u32(const char*& p, const char* end, unsigned& value) {
+    if (end - p < 4) return false;
+    value = 0;
+    for (int i = 0; i < 4; ++i) value |= (unsigned)(unsigned char)p[i] << (8 * i);
+    p += 4;
+    return true;
+}
+
+bool OperationJournal::get_u64(const char*& p, const char* end, unsigned long long& value) {
+    if (end - p < 8) return false;
+    value = 0;
+    for (int i = 0; i < 8; ++i) value |= (unsigned long long)(unsigned char)p[i] << (8 * i);
+    p += 8;
+    return true;
+}
+
+bool OperationJournal::get_song(const char*& p, const char* end, Song& s) {
+    unsigned name_len, author_len, duration;
+    if (!get_u32(p, end, name_len) || (size_t)(end - p) < name_len) return false;
+    std::string name(p, name_len);
+    p += name_len;
+    if (!get_u32(p, end, author_len) || (size_t)(end - p) < author_len) return false;
+    std::string author(p, author_len);
+    p += author_len;
+    if (!get_u32(p, end, duration)) return false;
+    s = Song(name.c_str(), author.c_str(), (int)duration);
+    return true;
+}
+
+bool OperationJournal::decode_record(const char*& p, const char* end, JournalRecord& record) {
+    const char* cur = p;
+    unsigned size, sum;
+    if (!get_u32(cur, end, size) || !get_u32(cur, end, sum) || (size_t)(end - cur) < size) return false;
+    if (checksum(cur, size) != sum) return false;
+    const char* rec_end = cur + size;
+    record.arg = 0;
+    if (!get_u64(cur, rec_end, record.lsn) || cur == rec_end) return false;
+    record.op = JournalOp((unsigned char)*cur++);
+    if (record.op == JOP_ADD_BACK || record.op == JOP_ADD_FRONT) {
+        if (!get_song(cur, rec_end, record.song)) return false;
+    } else if (record.op == JOP_SHUFFLE) {
+        if (!get_u64(cur, rec_end, record.arg)) return false;
+    }
+    p = rec_end;
+    return true;
+}
+
+// Контрольна сума FNV-1a (32 біти)
+unsigned OperationJournal::checksum(const char* data, size_t size) {
+    unsigned hash = 2166136261u;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= (unsigned char)data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/* Метод відновлення. Знімок: [8 байт "PLSNAP01"][u64 LSN][u32 контрольна сума][дані].
+Знімок записується атомарно, тож пошкоджений знімок - це справжня втрата даних, а не обірваний
+запис, і відновлення зупиняється. Записи журналу мають іти підряд одразу після LSN знімка
+(записи з меншим LSN вже враховані у знімку). Записи читаються до першого обірваного або
+пошкодженого; файл обрізається по останньому цілому запису, щоб нові записи не опинилися
+після "сміття" */
+template <typename SnapshotVisitor, typename RecordVisitor>
+JournalRecovery OperationJournal::recover(SnapshotVisitor on_snapshot, RecordVisitor on_record) {
+    bool recovered = false;
+    unsigned long long snapshot_lsn = 0;
+    std::ifstream snapshot(snapshot_path, std::ios::binary);
+    if (snapshot) {
+        std::string data((std::istreambuf_iterator<char>(snapshot)), std::istreambuf_iterator<char>());
+        const char* p = data.data();
+        const char* end = p + data.size();
+        unsigned sum = 0;
+        if (data.size() < 8 || data.compare(0, 8, "PLSNAP01") != 0) return JR_BAD_SNAPSHOT;
+        p += 8;
+        if (!get_u64(p, end, snapshot_lsn) || !get_u32(p, end, sum) || checksum(p, end - p) != sum)
+            return JR_BAD_SNAPSHOT;
+        on_snapshot(p, (size_t)(end - p));
+        recovered = true;
+    }
+
+    unsigned long long last_lsn = snapshot_lsn;
+    std::ifstream journal(journal_path, std::ios::binary);
+    if (journal) {
+        std::string data((std::istreambuf_iterator<char>(journal)), std::istreambuf_iterator<char>());
+        journal.close();
+        const char* p = data.data();
+        const char* end = p + data.size();
+        const char* valid_end = p;
+        JournalRecord record;
+        while (p < end) {
+            if (!decode_record(p, end, record)) break;
+            valid_end = p;
+            if (record.lsn <= snapshot_lsn) continue; // вже враховано у знімку
+            if (record.lsn != last_lsn + 1) return JR_LSN_GAP;
+            on_record(record);
+            last_lsn = record.lsn;
+            recovered = true;
+        }
+        if (valid_end != end) {
+            std::error_code error;
+            std::filesystem::resize_file(journal_path, valid_end - data.data(), error);
+            if (error) return JR_TRUNCATE_FAILED;
+        }
+    }
+    next_lsn = last_lsn + 1;
+    written_lsn = last_lsn;
+    return recovered ? JR_RECOVERED : JR_EMPTY;
+}
+
+// Метод, що відкриває журнал для дописування і запускає потік запису
+bool OperationJournal::start() {
+    file = std::fopen(journal_path.c_str(), "ab");
+    if (file == nullptr) return false;
+    writer = std::thread(&OperationJournal::writer_loop, this);
+    return true;
+}
+
+// Метод, що задає дзеркальну копію стану, з якої потік запису робить знімки
+void OperationJournal::set_mirror(std::function<void(const JournalRecord&)> apply,
+                                  std::function<std::string()> serialize) {
+    mirror_apply = std::move(apply);
+    mirror_serialize = std::move(serialize);
+}
+
+// Метод, що додає запис про операцію в чергу. Викликач тримає м'ютекс лише на час копіювання байтів
+void OperationJournal::append(JournalOp op, const Song* song, unsigned long long arg) {
+    std::string payload;
+    payload.reserve(64);
+    put_u64(payload, 0); // місце під LSN, який присвоюється під м'ютексом
+    payload += char(op);
+    if (song != nullptr) put_song(payload, *song);
+    if (op == JOP_SHUFFLE) put_u64(payload, arg);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        unsigned long long lsn = next_lsn++;
+        for (int i = 0; i < 8; ++i) payload[i] = char((lsn >> (8 * i)) & 0xFF);
+        put_u32(pending, (unsigned)payload.size());
+        put_u32(pending, checksum(payload.data(), payload.size()));
+        pending += payload;
+        ++pending_records;
+    }
+    wake_writer.notify_one();
+}
+
+// Метод, що чекає, поки всі додані записи будуть записані у файл (або журнал зламається)
+bool OperationJournal::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    const unsigned long long target = next_lsn - 1;
+    written.wait(lock, [&] { return written_lsn >= target || write_failed || !writer.joinable(); });
+    return written_lsn >= target && !write_failed;
+}
+
+// Метод, що перевіряє чи не стався збій запису в журнал
+bool OperationJournal::failed() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return write_failed;
+}
+
+/* Запис знімка: тимчасовий файл -> fsync -> атомарне перейменування -> fsync каталогу ->
+обнулення журналу. Обнулення - лише після того, як перейменування гарантовано на диску,
+інакше збій міг би зберегти порожній журнал разом зі старим знімком. Журнал обрізається
+на місці, тож файл лишається відкритим і подальші записи не губляться */
+void OperationJournal::write_snapshot(const std::string& data, unsigned long long lsn) {
+    std::string header("PLSNAP01");
+    put_u64(header, lsn);
+    put_u32(header, checksum(data.data(), data.size()));
+    const std::string tmp_path = snapshot_path + ".tmp";
+    FILE* out = std::fopen(tmp_path.c_str(), "wb");
+    if (out == nullptr) return; // журнал лишається повним, тож стан не втрачено
+    bool ok = std::fwrite(header.data(), 1, header.size(), out) == header.size()
+              && std::fwrite(data.data(), 1, data.size(), out) == data.size();
+    ok = sync_file(out) && ok;
+    std::fclose(out);
+    std::error_code error;
+    if (ok) std::filesystem::rename(tmp_path, snapshot_path, error);
+    if (!ok || error || !sync_parent_directory(snapshot_path)) return;
+    /* Якщо програма впаде тут, у журналі лишаться записи, вже враховані у знімку;
+    під час відновлення їх відкине перевірка LSN. Так само, якщо обрізати не вдалося */
+    std::filesystem::resize_file(journal_path, 0, error);
+}
+
+/* Цикл потоку запису: забирає все накопичене і пише однією групою, потім повторює групу
+над дзеркалом і, коли настав час, записує знімок. LSN групи вважається записаним, лише
+якщо fwrite та fflush/fsync пройшли успішно */
+void OperationJournal::writer_loop() {
+    size_t unsynced = 0;
+    size_t since_checkpoint = 0;
+    const bool checkpoints = options.checkpoint_every > 0 && mirror_apply && mirror_serialize;
+    JournalRecord record;
+    std::string batch;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake_writer.wait(lock, [&] { return stopping || pending_records > 0; });
+        if (pending_records == 0 && stopping) break;
+        batch.clear();
+        batch.swap(pending);
+        const size_t records = pending_records;
+        const unsigned long long last = next_lsn - 1;
+        pending_records = 0;
+        bool ok = !write_failed;
+        lock.unlock();
+
+        if (ok) {
+            ok = std::fwrite(batch.data(), 1, batch.size(), file) == batch.size();
+            unsynced += records;
+            if (ok && options.fsync_every > 0 && unsynced >= options.fsync_every) {
+                ok = sync_file(file);
+                unsynced = 0;
+            } else if (ok) {
+                ok = std::fflush(file) == 0;
+            }
+        }
+        if (ok && checkpoints) {
+            const char* p = batch.data();
+            const char* end = p + batch.size();
+            while (p < end && decode_record(p, end, record))
+                mirror_apply(record);
+            since_checkpoint += records;
+            if (since_checkpoint >= options.checkpoint_every) {
+                write_snapshot(mirror_serialize(), last);
+                since_checkpoint = 0;
+                unsynced = 0;
+            }
+        }
+
+        lock.lock();
+        if (ok) written_lsn = last;
+        else write_failed = true;
+        written.notify_all();
+    }
+    lock.unlock();
+    sync_file(file);
+}
+
+/////////////////////////// ОСНОВНА ПРОГРАМА ///////////////////////////////
+
+// Процедура для виводу у вихідний потік інструкції для користувача
 void print_menu() {
     std::cout << "\n========== МЕНЮ ПЛЕЙЛИСТА ==========\n";
     std::cout << "1  - Додати пісню в кінець\n";
@@ -687,6 +2499,17 @@ void print_menu() {
     std::cout << "11 - Очистити плейлист\n";
     std::cout << "12 - Обміняти з іншим плейлистом\n";
     std::cout << "13 - Злити з іншим плейлистом\n";
+    std::cout << "14 - Перемішати плейлист\n";
+    std::cout << "15 - Відтворити у випадковому порядку\n";
+    std::cout << "16 - Знайти за початком назви або автора\n";
+    std::cout << "17 - Знайти за фрагментом назви або автора\n";
+    std::cout << "18 - Показати короткі пісні (<3хв)\n";
+    std::cout << "19 - Показати перші N довгих пісень автора\n";
+    std::cout << "20 - Показати N найдовших пісень\n";
+    std::cout << "21 - Показати N найкоротших пісень\n";
+    std::cout << "22 - Додати пісню в чергу відтворення\n";
+    std::cout << "23 - Показати чергу відтворення\n";
+    std::cout << "24 - Показати пісню з медіанною тривалістю\n";
     std::cout << "0  - Вихід\n";
     std::cout << "-1  - Надіслати прелік команд знову\n";
 }
@@ -700,15 +2523,767 @@ void print_song(const Song& s, int num) {
     std::cout << s.duration % 60 << ")\n";
 }
 
+/////////////////////////// СЕСІЯ ПЛЕЙЛИСТІВ ///////////////////////////////
+
+const size_t search_result_limit = 10; // Максимальна кількість результатів пошуку за запитом
+
+/* Стан програми: два плейлисти, їх індекси пошуку та операції над ними. Через ці методи
+працюють і інтерактивне меню, і пакетний режим, тому обидва виконують однакові дії,
+а індекси завжди відповідають вмісту своїх плейлистів */
+struct PlaylistSession {
+    Linked2List<Song> playlist1; // Основний плейлист (з ним працює меню)
+    Linked2List<Song> playlist2; // Другий плейлист (для обміну та злиття)
+    SongIndex index1; // Індекс пошуку основного плейлиста
+    SongIndex index2; // Індекс пошуку другого плейлиста (щоб обмін лишався O(1))
+    std::mt19937_64 rng; // Генератор випадкових чисел для перемішування
+    OperationJournal* journal; // Журнал змін (nullptr - журналювання вимкнене)
+    /* Черга відтворення: пісні обох плейлистів, зв'язані через власний гачок, без копіювання.
+    Оголошена після плейлистів, тож знищується раніше за їх вузли. В журнал не пишеться */
+    IntrusiveLinked2List<Song, &Song::queue_hook> queue;
+
+    /* Конструктор з параметрами (початкове значення генератора; indexed = false - без індексів
+    пошуку, для дзеркальної копії стану, з якої потік журналу робить знімки) */
+    PlaylistSession(unsigned long long seed, bool indexed = true)
+        : index1(indexed), index2(indexed), rng(seed), journal(nullptr) {}
+    // Метод, що записує операцію в журнал (знімки стану робить сам потік журналу)
+    void log(JournalOp op, const Song* s = nullptr, unsigned long long arg = 0) {
+        if (journal != nullptr) journal -> append(op, s, arg);
+    }
+    // Метод, що виключає з черги відтворення всі пісні плейлиста (перед знищенням його вузлів)
+    void unqueue(Linked2List<Song>& list) {
+        if (queue.empty()) return;
+        for (Song& s : list) queue.erase(s);
+    }
+    // Метод, що ставить пісню в кінець черги відтворення. Повертає false, якщо вона вже в черзі
+    bool enqueue(Song& s) {
+        return queue.push_back(s);
+    }
+    // Метод, що серіалізує обидва плейлисти для знімка журналу
+    std::string snapshot() const {
+        std::string out;
+        const Linked2List<Song>* lists[2] = { &playlist1, &playlist2 };
+        for (const Linked2List<Song>* list : lists) {
+            OperationJournal::put_u64(out, list -> size());
+            for (auto it = list -> begin(); it != list -> end(); ++it)
+                OperationJournal::put_song(out, *it);
+        }
+        return out;
+    }
+    // Метод, що відновлює обидва плейлисти зі знімка журналу
+    void load_snapshot(const char* data, size_t size) {
+        const char* end = data + size;
+        Linked2List<Song>* lists[2] = { &playlist1, &playlist2 };
+        for (Linked2List<Song>* list : lists) {
+            unqueue(*list);
+            list -> clear();
+            unsigned long long count = 0;
+            OperationJournal::get_u64(data, end, count);
+            Song s;
+            for (unsigned long long i = 0; i < count && OperationJournal::get_song(data, end, s); ++i)
+                list -> push_back(s);
+        }
+        index1.rebuild(playlist1);
+        index2.rebuild(playlist2);
+    }
+    // Метод, що повторює операцію, прочитану з журналу (сам у журнал нічого не пише)
+    void replay(const JournalRecord& record) {
+        OperationJournal* saved = journal;
+        journal = nullptr;
+        switch (record.op) {
+            case JOP_ADD_BACK: add_back(record.song); break;
+            case JOP_ADD_FRONT: add_front(record.song); break;
+            case JOP_POP_BACK: remove_back(); break;
+            case JOP_POP_FRONT: remove_front(); break;
+            case JOP_REMOVE_LONG: remove_long(); break;
+            case JOP_SORT: sort(); break;
+            case JOP_CLEAR: clear(); break;
+            case JOP_SWAP: swap(); break;
+            case JOP_MERGE: merge(); break;
+            case JOP_SHUFFLE: shuffle_seeded(record.arg); break;
+        }
+        journal = saved;
+    }
+    // Метод для додавання пісні в кінець основного плейлиста
+    void add_back(const Song& s) {
+        playlist1.push_back(s);
+        auto last = playlist1.end();
+        index1.insert(--last);
+        log(JOP_ADD_BACK, &s);
+    }
+    // Метод для додавання пісні на початок основного плейлиста
+    void add_front(const Song& s) {
+        playlist1.push_front(s);
+        index1.insert(playlist1.begin());
+        log(JOP_ADD_FRONT, &s);
+    }
+    // Метод для видалення останньої пісні основного плейлиста
+    void remove_back() {
+        if (playlist1.empty()) return;
+        auto last = playlist1.end();
+        index1.erase(--last);
+        queue.erase(*last);
+        playlist1.pop_back();
+        log(JOP_POP_BACK);
+    }
+    // Метод для видалення першої пісні основного плейлиста
+    void remove_front() {
+        if (playlist1.empty()) return;
+        index1.erase(playlist1.begin());
+        queue.erase(*playlist1.begin());
+        playlist1.pop_front();
+        log(JOP_POP_FRONT);
+    }
+    // Метод, що шукає пісню за назвою, повертає ітератор на першу знайдену або end()
+    Linked2List<Song>::iterator find_by_name(const char* name) {
+        for (auto it = playlist1.begin(); it != playlist1.end(); ++it)
+            if (strcmp_equal(it->name, name)) return it;
+        return playlist1.end();
+    }
+    // Метод для видалення довгих пісень (>5хв) з основного плейлиста
+    void remove_long() {
+        for (auto it = playlist1.begin(); it != playlist1.end(); ) {
+            if (is_long_song(*it)) {
+                index1.erase(it);
+                queue.erase(*it);
+                it = playlist1.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        log(JOP_REMOVE_LONG);
+    }
+    // Метод для сортування основного плейлиста за тривалістю (вузли лише перезв'язуються, тож індекс лишається дійсним)
+    void sort() {
+        playlist1.sort_by_key(song_duration);
+        log(JOP_SORT);
+    }
+    // Метод для очищення основного плейлиста
+    void clear() {
+        unqueue(playlist1);
+        playlist1.clear();
+        index1.clear();
+        log(JOP_CLEAR);
+    }
+    // Метод для обміну вмістом двох плейлистів
+    void swap() {
+        playlist1.swap(playlist2);
+        index1.swap(index2);
+        log(JOP_SWAP);
+    }
+    // Метод, що сортує обидва плейлисти і зливає другий в основний. Повертає false, якщо другий порожній
+    bool merge() {
+        if (playlist2.empty()) return false;
+        playlist1.sort_by_key(song_duration);
+        playlist2.sort_by_key(song_duration);
+        unqueue(playlist2); // merge копіює пісні другого плейлиста, а його вузли знищує
+        playlist1.merge(playlist2);
+        index1.rebuild(playlist1);
+        index2.clear();
+        log(JOP_MERGE);
+        return true;
+    }
+    /* Метод для перемішування основного плейлиста. В журнал пишеться лише seed, з яким
+    перемішування під час відновлення дасть той самий порядок */
+    void shuffle() {
+        shuffle_seeded(rng());
+    }
+    void shuffle_seeded(unsigned long long seed) {
+        std::mt19937_64 gen(seed);
+        playlist1.shuffle(gen);
+        log(JOP_SHUFFLE, nullptr, seed);
+    }
+};
+
+/////////////////////////// ПАКЕТНИЙ РЕЖИМ ///////////////////////////////
+
+/* Сценарій пакетного режиму - текстовий файл, по одній команді на рядок, поля розділені '|'.
+Порожні рядки та рядки, що починаються з '#', пропускаються. Команди (в дужках - пункт меню):
+    add|назва|автор|секунди        (1)      add_front|назва|автор|секунди  (2)
+    pop_back                       (5)      pop_front                      (6)
+    find|назва                     (7)      remove_long                    (8)
+    sort                           (9)      size                           (10)
+    clear                          (11)     swap                           (12)
+    merge                          (13)     shuffle                        (14)
+    find_prefix|запит              (16)     find_substring|запит           (17)
+Масові варіанти (N операцій однією командою, seed робить сценарій відтворюваним):
+    add_bulk|N|seed   add_front_bulk|N|seed   pop_back_bulk|N   pop_front_bulk|N   find_bulk|N|seed
+Пісні масових команд мають назви "Song <i>" та авторів "Author <i % 1000>", find_bulk шукає
+випадкові назви "Song <i>", де i не більше розміру основного плейлиста.
+Обидва плейлисти на початку сценарію порожні, тому результат не залежить від тестових пісень меню,
+а shuffle без --seed починає з default_script_seed, тож порядок після нього теж відтворюваний */
+
+const unsigned long long default_script_seed = 1; // Початкове значення генератора пакетного режиму
+
+// Типи команд пакетного режиму (порядок збігається з масивом script_command_names)
+enum ScriptCommand {
+    CMD_ADD, CMD_ADD_FRONT, CMD_POP_BACK, CMD_POP_FRONT, CMD_FIND, CMD_REMOVE_LONG,
+    CMD_SORT, CMD_SIZE, CMD_CLEAR, CMD_SWAP, CMD_MERGE, CMD_SHUFFLE, CMD_FIND_PREFIX, CMD_FIND_SUBSTRING,
+    CMD_ADD_BULK, CMD_ADD_FRONT_BULK, CMD_POP_BACK_BULK, CMD_POP_FRONT_BULK, CMD_FIND_BULK,
+    CMD_COUNT, CMD_UNKNOWN = CMD_COUNT
+};
+
+const char* const script_command_names[CMD_COUNT] = {
+    "add", "add_front", "pop_back", "pop_front", "find", "remove_long",
+    "sort", "size", "clear", "swap", "merge", "shuffle", "find_prefix", "find_substring",
+    "add_bulk", "add_front_bulk", "pop_back_bulk", "pop_front_bulk", "find_bulk"
+};
+
+// Статистика виконання команд одного типу
+struct ScriptStats {
+    size_t commands; // Кількість виконаних команд
+    size_t operations; // Кількість елементарних операцій (для масових команд - N)
+    double seconds; // Сумарний час виконання
+};
+
+/* Функція перетворення рядка (const char* str) на ціле число (long long& out).
+Повертає false, якщо рядок порожній, містить щось окрім цифр (і знаку мінус)
+або число не вміщується в long long */
+bool parse_int_custom(const char* str, long long& out) {
+    size_t i = 0;
+    bool negative = false;
+    if (str[0] == '-') {
+        negative = true;
+        ++i;
+    }
+    if (str[i] == '\0') return false;
+    long long value = 0;
+    for (; str[i] != '\0'; ++i) {
+        if (str[i] < '0' || str[i] > '9') return false;
+        int digit = str[i] - '0';
+        if (value > (LLONG_MAX - digit) / 10) return false;
+        value = value * 10 + digit;
+    }
+    out = negative ? -value : value;
+    return true;
+}
+// Процедура, що записує в масив (char* dest) рядок prefix, пробіл та число num
+void format_numbered(char* dest, const char* prefix, unsigned long long num) {
+    strcpy_custom(dest, prefix);
+    size_t len = strlen_custom(dest);
+    dest[len++] = ' ';
+    char digits[24];
+    size_t n = 0;
+    do {
+        digits[n++] = char('0' + num % 10);
+        num /= 10;
+    } while (num != 0);
+    while (n > 0) dest[len++] = digits[--n];
+    dest[len] = '\0';
+}
+// Функція, що повертає тип команди за її назвою (CMD_UNKNOWN, якщо такої немає)
+ScriptCommand script_command_by_name(const char* name) {
+    for (int i = 0; i < CMD_COUNT; ++i)
+        if (strcmp_equal(name, script_command_names[i])) return ScriptCommand(i);
+    return CMD_UNKNOWN;
+}
+// Функція, що створює i-ту пісню масових команд (duration у межах 60..659 секунд)
+Song make_bulk_song(unsigned long long i, std::mt19937_64& gen) {
+    char name[64], author[64];
+    format_numbered(name, "Song", i);
+    format_numbered(author, "Author", i % 1000);
+    return Song(name, author, 60 + int(gen() % 600));
+}
+
+/* Функція, що виконує одну команду сценарію над сесією без жодного виводу.
+fields - поля рядка (fields[0] - назва команди), field_count - їх кількість.
+До results додаються результати запитів (кількість знайдених пісень, розмір плейлиста):
+звіт їх друкує, тому компілятор не може викинути пошук, результат якого ніде не використано.
+Повертає кількість виконаних елементарних операцій або -1, якщо аргументи некоректні */
+long long run_script_command(PlaylistSession& session, ScriptCommand cmd, char** fields, int field_count,
+                             unsigned long long& results) {
+    long long n = 1, seed = 0, dur = 0;
+    switch (cmd) {
+        case CMD_ADD:
+        case CMD_ADD_FRONT: {
+            if (field_count != 4 || !parse_int_custom(fields[3], dur) || dur < 0 || dur > INT_MAX) return -1;
+            if (cmd == CMD_ADD) session.add_back(Song(fields[1], fields[2], int(dur)));
+            else session.add_front(Song(fields[1], fields[2], int(dur)));
+            return 1;
+        }
+        case CMD_FIND: {
+            if (field_count != 2) return -1;
+            results += session.find_by_name(fields[1]) != session.playlist1.end();
+            return 1;
+        }
+        case CMD_FIND_PREFIX:
+        case CMD_FIND_SUBSTRING: {
+            if (field_count != 2) return -1;
+            if (cmd == CMD_FIND_PREFIX) results += session.index1.find_prefix(fields[1], search_result_limit).size();
+            else results += session.index1.find_substring(fields[1], search_result_limit).size();
+            return 1;
+        }
+        case CMD_POP_BACK: session.remove_back(); return 1;
+        case CMD_POP_FRONT: session.remove_front(); return 1;
+        case CMD_REMOVE_LONG: session.remove_long(); return 1;
+        case CMD_SORT: session.sort(); return 1;
+        case CMD_SIZE: results += session.playlist1.size(); return 1;
+        case CMD_CLEAR: session.clear(); return 1;
+        case CMD_SWAP: session.swap(); return 1;
+        case CMD_MERGE: session.merge(); return 1;
+        case CMD_SHUFFLE: session.shuffle(); return 1;
+        case CMD_ADD_BULK:
+        case CMD_ADD_FRONT_BULK:
+        case CMD_FIND_BULK: {
+            if (field_count != 3 || !parse_int_custom(fields[1], n) || !parse_int_custom(fields[2], seed) || n < 0)
+                return -1;
+            std::mt19937_64 gen(seed);
+            for (long long i = 0; i < n; ++i) {
+                if (cmd == CMD_FIND_BULK) {
+                    char name[64];
+                    format_numbered(name, "Song", gen() % (session.playlist1.size() + 1));
+                    results += session.find_by_name(name) != session.playlist1.end();
+                } else if (cmd == CMD_ADD_BULK) {
+                    session.add_back(make_bulk_song(i, gen));
+                } else {
+                    session.add_front(make_bulk_song(i, gen));
+                }
+            }
+            return n;
+        }
+        case CMD_POP_BACK_BULK:
+        case CMD_POP_FRONT_BULK: {
+            if (field_count != 2 || !parse_int_custom(fields[1], n) || n < 0) return -1;
+            for (long long i = 0; i < n; ++i) {
+                if (cmd == CMD_POP_BACK_BULK) session.remove_back();
+                else session.remove_front();
+            }
+            return n;
+        }
+        default:
+            return -1;
+    }
+}
+
+/* Функція пакетного режиму: читає команди з потоку (std::istream& in), виконує їх без
+підказок і проміжного виводу, а наприкінці друкує звіт: кількість команд кожного типу,
+сумарний час та пропускну здатність. Повертає код завершення програми */
+int run_script(std::istream& in, PlaylistSession& session) {
+    ScriptStats stats[CMD_COUNT] = {};
+    unsigned long long results = 0; // Сума результатів запитів (знайдені пісні, розміри)
+    size_t errors = 0;
+    size_t line_no = 0;
+    char line[1024];
+    const int max_fields = 4;
+    char* fields[max_fields];
+
+    while (in.getline(line, sizeof(line)) || in.gcount() > 0) {
+        ++line_no;
+        if (in.fail() && !in.eof()) { // рядок довший за буфер
+            in.clear();
+            in.ignore(1 << 30, '\n');
+            std::cerr << "Рядок " << line_no << ": занадто довгий рядок\n";
+            ++errors;
+            continue;
+        }
+        size_t len = strlen_custom(line);
+        if (len > 0 && line[len - 1] == '\r') line[--len] = '\0';
+        if (len == 0 || line[0] == '#') continue;
+
+        // Розбиваємо рядок на поля на місці, замінюючи '|' на '\0'
+        int field_count = 0;
+        fields[field_count++] = line;
+        for (size_t i = 0; i < len && field_count <= max_fields; ++i) {
+            if (line[i] == '|') {
+                line[i] = '\0';
+                if (field_count == max_fields) {
+                    field_count = max_fields + 1;
+                    break;
+                }
+                fields[field_count++] = line + i + 1;
+            }
+        }
+
+        ScriptCommand cmd = script_command_by_name(fields[0]);
+        long long done = -1;
+        auto start = std::chrono::steady_clock::now();
+        if (cmd != CMD_UNKNOWN && field_count <= max_fields)
+            done = run_script_command(session, cmd, fields, field_count, results);
+        auto finish = std::chrono::steady_clock::now();
+
+        if (done < 0) {
+            std::cerr << "Рядок " << line_no << ": невідома команда або некоректні аргументи\n";
+            ++errors;
+            continue;
+        }
+        stats[cmd].commands += 1;
+        stats[cmd].operations += size_t(done);
+        stats[cmd].seconds += std::chrono::duration<double>(finish - start).count();
+    }
+
+    ScriptStats total = {};
+    std::cout << "\n========== ЗВІТ ПАКЕТНОГО РЕЖИМУ ==========\n";
+    // setw рахує байти, а не символи UTF-8, тому заголовок вирівнюємо вручну
+    std::cout << "Команда             Команд    Операцій    Час (мс)          Оп/с\n";
+    std::cout << std::fixed << std::setprecision(3);
+    for (int i = 0; i < CMD_COUNT; ++i) {
+        if (stats[i].commands == 0) continue;
+        total.commands += stats[i].commands;
+        total.operations += stats[i].operations;
+        total.seconds += stats[i].seconds;
+        std::cout << std::left << std::setw(16) << script_command_names[i] << std::right
+                  << std::setw(10) << stats[i].commands << std::setw(12) << stats[i].operations
+                  << std::setw(12) << stats[i].seconds * 1000.0 << std::setw(14) << std::setprecision(0)
+                  << (stats[i].seconds > 0 ? stats[i].operations / stats[i].seconds : 0.0)
+                  << std::setprecision(3) << "\n";
+    }
+    std::cout << "-------------------------------------------\n";
+    std::cout << "Всього команд: " << total.commands << ", операцій: " << total.operations
+              << ", помилок: " << errors << "\n";
+    std::cout << "Загальний час: " << total.seconds * 1000.0 << " мс, пропускна здатність: "
+              << std::setprecision(0) << (total.seconds > 0 ? total.operations / total.seconds : 0.0) << " оп/с\n";
+    std::cout << "Розмір плейлистів: " << session.playlist1.size() << " / " << session.playlist2.size() << "\n";
+    std::cout << "Результати запитів (знайдено пісень + розміри): " << results << "\n";
+    return errors == 0 ? 0 : 1;
+}
+
+/* Функція заміру затримки редагування з журналом і без нього: у свіжу сесію додається
+n пісень (як add_bulk), час кожної операції вимірюється окремо. Знімки робить потік
+журналу, тож у затримку редагування входить усе, що відбувається на потоці викликача.
+Для журналу окремо показано, скільки ще довелося чекати, поки потік запису передасть
+усе у файл. Файли пишуться лише у власний тимчасовий каталог заміру, який потім
+видаляється, тому журнал з --journal замір ніколи не зачіпає. Повертає код завершення */
+int run_journal_benchmark(long long n, JournalOptions base) {
+    struct Config {
+        const char* title; // Назва конфігурації
+        bool enabled; // Чи ввімкнено журнал
+        size_t fsync_every; // Частота fsync
+    };
+    const Config configs[] = {
+        { "без журналу", false, 0 },
+        { "журнал, fsync на кожну групу", true, 1 },
+        { "журнал, fsync кожні 64 записи", true, 64 },
+        { "журнал без fsync", true, 0 },
+    };
+    // Власний каталог створюється з випадковою назвою; вже наявний каталог ніколи не використовується
+    std::random_device seed_source;
+    std::filesystem::path dir;
+    std::error_code error;
+    for (int attempt = 0; ; ++attempt) {
+        dir = std::filesystem::temp_directory_path(error) / ("playlist_journal_bench_" + std::to_string(seed_source()));
+        if (!error && std::filesystem::create_directory(dir, error)) break;
+        if (attempt == 16) {
+            std::cerr << "Не вдалося створити тимчасовий каталог для заміру журналу\n";
+            return 2;
+        }
+    }
+    const std::string prefix = (dir / "bench").string();
+
+    std::cout << "Замір затримки редагування: " << n << " операцій add, знімок кожні "
+              << base.checkpoint_every << " записів\n";
+    std::cout << std::fixed << std::setprecision(2);
+    int result = 0;
+    for (const Config& config : configs) {
+        std::filesystem::remove(prefix + ".journal", error);
+        std::filesystem::remove(prefix + ".snapshot", error);
+        PlaylistSession session(1);
+        PlaylistSession mirror(1, false);
+        JournalOptions options = base;
+        options.fsync_every = config.fsync_every;
+        OperationJournal* journal = config.enabled ? new OperationJournal(prefix.c_str(), options) : nullptr;
+        if (journal != nullptr) {
+            journal -> set_mirror([&mirror](const JournalRecord& record) { mirror.replay(record); },
+                                  [&mirror] { return mirror.snapshot(); });
+            if (!journal -> start()) {
+                std::cerr << "Не вдалося відкрити журнал " << prefix << ".journal\n";
+                delete journal;
+                result = 2;
+                break;
+            }
+        }
+        session.journal = journal;
+
+        std::vector<double> latency((size_t)n);
+        std::mt19937_64 gen(1);
+        auto begin = std::chrono::steady_clock::now();
+        for (long long i = 0; i < n; ++i) {
+            Song s = make_bulk_song(i, gen);
+            auto start = std::chrono::steady_clock::now();
+            session.add_back(s);
+            latency[i] = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        }
+        auto edits_done = std::chrono::steady_clock::now();
+        if (journal != nullptr && !journal -> flush()) {
+            std::cerr << "Помилка запису журналу " << prefix << ".journal\n";
+            result = 2;
+        }
+        auto flushed = std::chrono::steady_clock::now();
+        session.journal = nullptr;
+        delete journal;
+
+        double sum = 0;
+        for (double v : latency) sum += v;
+        std::sort(latency.begin(), latency.end());
+        double seconds = std::chrono::duration<double>(edits_done - begin).count();
+        std::cout << "\n--- " << config.title << " ---\n";
+        if (n > 0) {
+            std::cout << "Затримка (мкс): середня " << sum / n << ", p50 " << latency[n / 2]
+                      << ", p99 " << latency[(size_t)(n * 0.99)] << ", макс " << latency[n - 1] << "\n";
+        }
+        std::cout << "Пропускна здатність: " << std::setprecision(0) << (seconds > 0 ? n / seconds : 0.0)
+                  << " оп/с" << std::setprecision(2) << "\n";
+        if (config.enabled)
+            std::cout << "Очікування запису у файл після останньої операції: "
+                      << std::chrono::duration<double, std::milli>(flushed - edits_done).count() << " мс\n";
+    }
+    std::filesystem::remove_all(dir, error);
+    return result;
+}
+
 /////////////////////////// ГОЛОВНА ПРОГРАМА ///////////////////////////////
 
-int main() {
-    Linked2List<Song> playlist1;
-    Linked2List<Song> playlist2;
-    // Додамо тестові пісні
-    playlist1.push_back(Song("Bohemian Rhapsody", "Queen", 354));
-    playlist1.push_back(Song("Imagine", "John Lennon", 183));
-    playlist1.push_back(Song("Stairway to Heaven", "Led Zeppelin", 482));
+/* Процедура заміру сортування за тривалістю: sort_by_key (порозрядне сортування) проти
+наявного sort(compare_by_duration) (сортування вставкою, O(n^2)). Старе сортування
+міряється лише на перших insertion_limit піснях, інакше замір тривав би години */
+void run_sort_benchmark(long long n) {
+    const long long insertion_limit = 20000;
+    const long long small = n < insertion_limit ? n : insertion_limit;
+    std::mt19937_64 gen(1);
+    Linked2List<Song> big;
+    for (long long i = 0; i < n; ++i)
+        big.push_back(make_bulk_song(i, gen));
+    Linked2List<Song> by_insertion;
+    Linked2List<Song> by_radix;
+    auto it = big.begin();
+    for (long long i = 0; i < small; ++i, ++it) {
+        by_insertion.push_back(*it);
+        by_radix.push_back(*it);
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    auto start = std::chrono::steady_clock::now();
+    by_insertion.sort(compare_by_duration);
+    auto middle = std::chrono::steady_clock::now();
+    by_radix.sort_by_key(song_duration);
+    auto finish = std::chrono::steady_clock::now();
+    std::cout << "Сортування " << small << " пісень:\n";
+    std::cout << "  sort(compare_by_duration): "
+              << std::chrono::duration<double, std::milli>(middle - start).count() << " мс\n";
+    std::cout << "  sort_by_key(song_duration): "
+              << std::chrono::duration<double, std::milli>(finish - middle).count() << " мс\n";
+    std::cout << "  Результати " << (by_insertion == by_radix ? "збігаються" : "НЕ збігаються") << "\n";
+
+    // Вибір 100 найдовших без сортування міряємо до сортування, на тому ж невпорядкованому списку
+    start = std::chrono::steady_clock::now();
+    std::vector<Linked2List<Song>::iterator> top = big.top_k(100, is_longer);
+    finish = std::chrono::steady_clock::now();
+    std::cout << n << " пісень:\n";
+    std::cout << "  top_k(100, is_longer): "
+              << std::chrono::duration<double, std::milli>(finish - start).count() << " мс\n";
+    start = std::chrono::steady_clock::now();
+    big.sort_by_key(song_duration);
+    finish = std::chrono::steady_clock::now();
+    std::cout << "  sort_by_key(song_duration): "
+              << std::chrono::duration<double, std::milli>(finish - start).count() << " мс\n";
+}
+
+/* Процедура оцінки пам'яті: playlists плейлистів по songs_per_playlist пісень над каталогом
+з catalog_size пісень. Плейлисти з дескрипторів справді створюються, а пам'ять варіанту з
+глибокими копіями Song розраховується за тими самими піснями (вузол + назва + автор).
+Службові дані malloc (близько 16 байтів на виділення) не враховано в жодному з варіантів */
+void run_catalog_benchmark(long long catalog_size, long long playlists, long long songs_per_playlist) {
+    SongCatalog catalog;
+    std::mt19937_64 gen(1);
+    for (long long i = 0; i < catalog_size; ++i)
+        catalog.add(make_bulk_song(i, gen));
+    if (catalog.size() == 0) return;
+
+    std::vector<Linked2List<SongHandle>> lists((size_t)playlists);
+    size_t handle_nodes = 0;
+    size_t string_bytes = 0; // Рядки, які мали б копії Song у тих самих плейлистах
+    for (Linked2List<SongHandle>& list : lists) {
+        for (long long j = 0; j < songs_per_playlist; ++j) {
+            SongHandle h = catalog.handle((unsigned)(gen() % catalog.size()));
+            list.push_back(h);
+            string_bytes += strlen_custom(catalog.name(h)) + 1 + strlen_custom(catalog.author(h)) + 1;
+        }
+        handle_nodes += list.size() + 1; // + sentinel
+    }
+    const size_t catalog_bytes = catalog.memory_bytes();
+    const size_t handle_bytes = handle_nodes * sizeof(t_node<SongHandle>);
+    const size_t copy_bytes = handle_nodes * sizeof(t_node<Song>) + string_bytes;
+    const double mb = 1024.0 * 1024.0;
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Каталог: " << catalog.size() << " пісень, " << catalog.author_count() << " авторів, "
+              << catalog_bytes / mb << " МБ\n";
+    std::cout << "Плейлисти: " << playlists << " x " << songs_per_playlist << " пісень\n";
+    std::cout << "  з дескрипторами: " << handle_bytes / mb << " МБ (" << sizeof(t_node<SongHandle>)
+              << " байтів на вузол), разом з каталогом " << (handle_bytes + catalog_bytes) / mb << " МБ\n";
+    std::cout << "  з копіями Song:  " << copy_bytes / mb << " МБ (" << sizeof(t_node<Song>)
+              << " байтів на вузол + рядки назви та автора)\n";
+    std::cout << "  виділень пам'яті: " << handle_nodes << " з дескрипторами проти " << 3 * handle_nodes
+              << " з копіями Song (вузол, назва, автор)\n";
+
+    // Час копіювання та порівняння одного плейлиста в обох варіантах
+    Linked2List<Song> songs_list;
+    for (auto it = lists[0].begin(); it != lists[0].end(); ++it)
+        songs_list.push_back(catalog.to_song(*it));
+    std::cout << std::setprecision(3);
+    auto start = std::chrono::steady_clock::now();
+    Linked2List<SongHandle> handle_copy(lists[0]);
+    auto middle = std::chrono::steady_clock::now();
+    Linked2List<Song> song_copy(songs_list);
+    auto finish = std::chrono::steady_clock::now();
+    std::cout << "Копіювання плейлиста: дескриптори "
+              << std::chrono::duration<double, std::milli>(middle - start).count() << " мс, Song "
+              << std::chrono::duration<double, std::milli>(finish - middle).count() << " мс\n";
+    start = std::chrono::steady_clock::now();
+    bool same_handles = handle_copy == lists[0];
+    middle = std::chrono::steady_clock::now();
+    bool same_songs = song_copy == songs_list;
+    finish = std::chrono::steady_clock::now();
+    std::cout << "Порівняння плейлистів (" << (same_handles && same_songs ? "рівні" : "різні") << "): дескриптори "
+              << std::chrono::duration<double, std::milli>(middle - start).count() << " мс, Song "
+              << std::chrono::duration<double, std::milli>(finish - middle).count() << " мс\n";
+}
+
+// Процедура для виводу довідки про аргументи командного рядка
+void print_usage(const char* program) {
+    std::cerr << "Використання: " << program << " [--script <файл | ->] [--journal <префікс>] [--seed N]\n"
+              << "       [--fsync-every N] [--checkpoint-every N] [--bench-journal N] [--bench-sort N]\n"
+              << "       [--bench-catalog <пісень> <плейлистів> <пісень у плейлисті>]\n";
+}
+
+/* Запуск без аргументів - інтерактивне меню.
+    --script <файл>        пакетний режим ("-" - читати команди зі стандартного вводу)
+    --journal <префікс>    журналювання змін у <префікс>.journal та <префікс>.snapshot;
+                           на старті стан відновлюється зі знімка та журналу
+    --fsync-every N        fsync після кожних N записів журналу (0 - лише на знімках), за замовч. 1
+    --checkpoint-every N   знімок стану кожні N записів (0 - без знімків), за замовч. 100000
+    --seed N               початкове значення генератора для перемішування
+                           (за замовч. випадкове, а в пакетному режимі - default_script_seed)
+    --bench-journal N      замір затримки N редагувань з журналом і без нього
+                           (у власному тимчасовому каталозі, --journal не використовується)
+    --bench-sort N         замір сортування N пісень за тривалістю
+    --bench-catalog C P L  оцінка пам'яті P плейлистів по L пісень над каталогом з C пісень */
+int main(int argc, char* argv[]) {
+    const char* script_path = nullptr; // Файл сценарію (nullptr - інтерактивне меню)
+    const char* journal_prefix = nullptr; // Префікс файлів журналу (nullptr - без журналу)
+    JournalOptions options = { 1, 100000 }; // Налаштування журналу
+    long long bench_edits = -1; // Кількість операцій для заміру журналу (-1 - без заміру)
+    long long bench_sort = -1; // Кількість пісень для заміру сортування (-1 - без заміру)
+    long long bench_catalog[3] = { -1, 0, 0 }; // Розмір каталогу, кількість і розмір плейлистів
+    long long seed = -1; // Початкове значення генератора (-1 - не задане)
+    for (int i = 1; i < argc; ++i) {
+        long long value = 0;
+        bool has_value = i + 1 < argc;
+        if (strcmp_equal(argv[i], "--script") && has_value) {
+            script_path = argv[++i];
+        } else if (strcmp_equal(argv[i], "--journal") && has_value) {
+            journal_prefix = argv[++i];
+        } else if (strcmp_equal(argv[i], "--fsync-every") && has_value && parse_int_custom(argv[i + 1], value) && value >= 0) {
+            options.fsync_every = (size_t)value;
+            ++i;
+        } else if (strcmp_equal(argv[i], "--checkpoint-every") && has_value && parse_int_custom(argv[i + 1], value) && value >= 0) {
+            options.checkpoint_every = (size_t)value;
+            ++i;
+        } else if (strcmp_equal(argv[i], "--seed") && has_value && parse_int_custom(argv[i + 1], seed) && seed >= 0) {
+            ++i;
+        } else if (strcmp_equal(argv[i], "--bench-journal") && has_value && parse_int_custom(argv[i + 1], value) && value >= 0) {
+            bench_edits = value;
+            ++i;
+        } else if (strcmp_equal(argv[i], "--bench-sort") && has_value && parse_int_custom(argv[i + 1], value) && value >= 0) {
+            bench_sort = value;
+            ++i;
+        } else if (strcmp_equal(argv[i], "--bench-catalog") && i + 3 < argc
+                   && parse_int_custom(argv[i + 1], bench_catalog[0]) && parse_int_custom(argv[i + 2], bench_catalog[1])
+                   && parse_int_custom(argv[i + 3], bench_catalog[2])
+                   && bench_catalog[0] >= 0 && bench_catalog[1] > 0 && bench_catalog[2] >= 0) {
+            i += 3;
+        } else {
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+
+    /* Без --seed меню перемішує щоразу інакше, а пакетний режим бере фіксоване значення,
+    щоб той самий сценарій давав той самий результат */
+    if (seed < 0) seed = (script_path != nullptr) ? default_script_seed : (long long)std::random_device()();
+    PlaylistSession session((unsigned long long)seed);
+
+    if (bench_catalog[0] >= 0) {
+        run_catalog_benchmark(bench_catalog[0], bench_catalog[1], bench_catalog[2]);
+        return 0;
+    }
+    if (bench_sort >= 0) {
+        run_sort_benchmark(bench_sort);
+        return 0;
+    }
+    if (bench_edits >= 0) {
+        return run_journal_benchmark(bench_edits, options);
+    }
+
+    /* Журнал закривається (дописавши чергу) перед виходом з програми. Дзеркало - копія стану
+    без індексів, яку веде потік журналу, щоб робити знімки не зупиняючи редагування */
+    PlaylistSession mirror(0, false);
+    OperationJournal* journal = nullptr;
+    bool recovered = false;
+    if (journal_prefix != nullptr) {
+        journal = new OperationJournal(journal_prefix, options);
+        JournalRecovery recovery = journal -> recover(
+            [&](const char* data, size_t size) {
+                session.load_snapshot(data, size);
+                mirror.load_snapshot(data, size);
+            },
+            [&](const JournalRecord& record) {
+                session.replay(record);
+                mirror.replay(record);
+            });
+        if (recovery != JR_EMPTY && recovery != JR_RECOVERED) {
+            if (recovery == JR_BAD_SNAPSHOT)
+                std::cerr << "Знімок " << journal_prefix << ".snapshot пошкоджений";
+            else if (recovery == JR_LSN_GAP)
+                std::cerr << "Журнал " << journal_prefix << ".journal не продовжує знімок (бракує записів)";
+            else
+                std::cerr << "Не вдалося відрізати пошкоджений хвіст журналу " << journal_prefix << ".journal";
+            std::cerr << ": стан не можна відновити без втрат. Файли журналу не змінено, "
+                      << "перевірте їх або вкажіть інший --journal\n";
+            delete journal;
+            return 2;
+        }
+        recovered = recovery == JR_RECOVERED;
+        journal -> set_mirror([&mirror](const JournalRecord& record) { mirror.replay(record); },
+                              [&mirror] { return mirror.snapshot(); });
+        if (!journal -> start()) {
+            std::cerr << "Не вдалося відкрити журнал " << journal_prefix << ".journal\n";
+            delete journal;
+            return 2;
+        }
+        session.journal = journal;
+    }
+
+    int result = 0;
+    if (script_path != nullptr) {
+        if (strcmp_equal(script_path, "-")) {
+            result = run_script(std::cin, session);
+        } else {
+            std::ifstream script(script_path);
+            if (!script) {
+                std::cerr << "Не вдалося відкрити файл сценарію: " << script_path << "\n";
+                result = 2;
+            } else {
+                result = run_script(script, session);
+            }
+        }
+        if (journal != nullptr && !journal -> flush()) {
+            std::cerr << "Помилка запису журналу " << journal_prefix << ".journal: частину змін не збережено\n";
+            result = 2;
+        }
+        session.journal = nullptr;
+        delete journal;
+        return result;
+    }
+
+    Linked2List<Song>& playlist1 = session.playlist1;
+    // Додамо тестові пісні (якщо стан не відновлено з журналу)
+    if (recovered) {
+        std::cout << "Стан відновлено з журналу " << journal_prefix << ": " << playlist1.size()
+                  << " / " << session.playlist2.size() << " пісень\n";
+    } else {
+        session.add_back(Song("Bohemian Rhapsody", "Queen", 354));
+        session.add_back(Song("Imagine", "John Lennon", 183));
+        session.add_back(Song("Stairway to Heaven", "Led Zeppelin", 482));
+    }
     
     int choice; // Змінна, де зберігається вибір наступної дії користувача
     bool running = true; // Змінна, що використовується в якості прапорця, 
@@ -734,7 +3309,7 @@ int main() {
                 std::cin.getline(author, 256);
                 std::cout << "Тривалість (сек): ";
                 std::cin >> dur;
-                playlist1.push_back(Song(name, author, dur));
+                session.add_back(Song(name, author, dur));
                 std::cout << "Пісню додано!\n";
                 break;
             }
@@ -747,7 +3322,7 @@ int main() {
                 std::cin.getline(author, 256);
                 std::cout << "Тривалість (сек): ";
                 std::cin >> dur;
-                playlist1.push_front(Song(name, author, dur));
+                session.add_front(Song(name, author, dur));
                 std::cout << "Пісню додано на початок!\n";
                 break;
             }
@@ -777,7 +3352,7 @@ int main() {
             }
             case 5: { // pop_back
                 if (!playlist1.empty()) {
-                    playlist1.pop_back();
+                    session.remove_back();
                     std::cout << "Останню пісню видалено!\n";
                 } else {
                     std::cout << "Плейлист порожній!\n";
@@ -786,7 +3361,7 @@ int main() {
             }
             case 6: { // pop_front
                 if (!playlist1.empty()) {
-                    playlist1.pop_front();
+                    session.remove_front();
                     std::cout << "Першу пісню видалено!\n";
                 } else {
                     std::cout << "Плейлист порожній!\n";
@@ -814,12 +3389,12 @@ int main() {
                 break;
             }
             case 8: { // remove за предикатом
-                playlist1.remove(is_long_song);
+                session.remove_long();
                 std::cout << "Довгі пісні видалено!\n";
                 break;
             }
             case 9: { // sort
-                playlist1.sort(compare_by_duration);
+                session.sort();
                 std::cout << "Плейлист відсортовано!\n";
                 break;
             }
@@ -828,27 +3403,138 @@ int main() {
                 break;
             }
             case 11: { // clear
-                playlist1.clear();
+                session.clear();
                 std::cout << "Плейлист очищено!\n";
                 break;
             }
             case 12: { // swap
                 std::cout << "Обмін з другим плейлистом...\n";
-                playlist1.swap(playlist2);
+                session.swap();
                 std::cout << "Плейлисти обмінено!\n";
                 break;
             }
             case 13: { // merge
-                if (playlist2.empty()) {
+                if (!session.merge()) {
                     std::cout << "Другий плейлист порожній!\n";
                 } else {
-                    playlist1.sort(compare_by_duration);
-                    playlist2.sort(compare_by_duration);
-                    playlist1.merge(playlist2);
                     std::cout << "Плейлисти злито!\n";
                 }
                 break;
             }
+            case 14: { // shuffle
+                session.shuffle();
+                std::cout << "Плейлист перемішано!\n";
+                break;
+            }
+            case 15: { // Відтворення у випадковому порядку (shuffle_cursor)
+                if (playlist1.empty()) {
+                    std::cout << "Плейлист порожній!\n";
+                } else {
+                    std::cout << "\n--- ВИПАДКОВИЙ ПОРЯДОК ---\n";
+                    int i = 1;
+                    for (Linked2List<Song>::shuffle_cursor cur(playlist1, session.rng()); !cur.done(); ++cur) {
+                        print_song(*cur, i++);
+                    }
+                }
+                break;
+            }
+            case 16:
+            case 17: { // Пошук через індекс (префіксне дерево / триграми)
+                char query[256];
+                std::cout << "Введіть запит: ";
+                std::cin.getline(query, 256);
+                std::vector<Linked2List<Song>::iterator> found = (choice == 16)
+                    ? session.index1.find_prefix(query, search_result_limit)
+                    : session.index1.find_substring(query, search_result_limit);
+                if (found.empty()) {
+                    std::cout << "Пісень не знайдено!\n";
+                } else {
+                    std::cout << "\n--- РЕЗУЛЬТАТИ ПОШУКУ ---\n";
+                    for (size_t i = 0; i < found.size(); ++i)
+                        print_song(*found[i], int(i + 1));
+                }
+                break;
+            }
+            case 18: { // Короткі пісні (подання filter, без копіювання плейлиста)
+                std::cout << "\n--- КОРОТКІ ПІСНІ ---\n";
+                int i = 1;
+                for (Song& s : playlist1 | views::filter(is_short_song))
+                    print_song(s, i++);
+                if (i == 1) std::cout << "Коротких пісень немає!\n";
+                break;
+            }
+            case 19: { // Перші N довгих пісень автора (подання filter | take)
+                char author[256];
+                int count;
+                std::cout << "Автор: ";
+                std::cin.getline(author, 256);
+                std::cout << "Кількість пісень: ";
+                std::cin >> count;
+                auto by_author = [&author](Song& s) { return is_long_song(s) && strcmp_equal(s.author, author); };
+                std::cout << "\n--- ДОВГІ ПІСНІ АВТОРА ---\n";
+                int i = 1;
+                for (Song& s : playlist1 | views::filter(by_author) | views::take(count > 0 ? count : 0))
+                    print_song(s, i++);
+                if (i == 1) std::cout << "Пісень не знайдено!\n";
+                break;
+            }
+            case 20:
+            case 21: { // N найдовших / найкоротших (top_k, плейлист не сортується)
+                int count;
+                std::cout << "Кількість пісень: ";
+                std::cin >> count;
+                if (count <= 0) {
+                    std::cout << "Невірна кількість!\n";
+                    break;
+                }
+                std::vector<Linked2List<Song>::iterator> top = (choice == 20)
+                    ? playlist1.top_k(count, is_longer)
+                    : playlist1.top_k(count, is_shorter);
+                if (top.empty()) {
+                    std::cout << "Плейлист порожній!\n";
+                } else {
+                    std::cout << (choice == 20 ? "\n--- НАЙДОВШІ ПІСНІ ---\n" : "\n--- НАЙКОРОТШІ ПІСНІ ---\n");
+                    for (size_t i = 0; i < top.size(); ++i)
+                        print_song(*top[i], int(i + 1));
+                }
+                break;
+            }
+            case 22: { // черга відтворення (інтрузивний список, пісня не копіюється)
+                char name[256];
+                std::cout << "Введіть назву пісні: ";
+                std::cin.getline(name, 256);
+                auto it = session.find_by_name(name);
+                if (it == playlist1.end()) {
+                    std::cout << "Пісню не знайдено!\n";
+                } else if (!session.enqueue(*it)) {
+                    std::cout << "Пісня вже в черзі!\n";
+                } else {
+                    std::cout << "Додано в чергу (" << session.queue.size() << ")\n";
+                }
+                break;
+            }
+            case 23: {
+                if (session.queue.empty()) {
+                    std::cout << "Черга порожня!\n";
+                } else {
+                    std::cout << "\n--- ЧЕРГА ВІДТВОРЕННЯ ---\n";
+                    int i = 1;
+                    for (Song& s : session.queue) print_song(s, i++);
+                }
+                break;
+            }
+            case 24: { // медіана за тривалістю (select_nth_by_key, плейлист не сортується)
+                auto median = playlist1.select_nth_by_key(playlist1.size() / 2, song_duration);
+                if (median == playlist1.end()) {
+                    std::cout << "Плейлист порожній!\n";
+                } else {
+                    int pos = 1; // Номер медіанної пісні в плейлисті (не її місце за тривалістю)
+                    for (auto it = playlist1.begin(); it != median; ++it) ++pos;
+                    std::cout << "Медіанна тривалість:\n";
+                    print_song(*median, pos);
+                }
+                break;
+            }
             case 0: { // для завершення користування програмою
                 running = false;
                 std::cout << "До побачення!\n";
@@ -862,6 +3548,17 @@ int main() {
             default:
                 std::cout << "Невірний вибір!\n";
         }
+        // Після збою запису журнал вимикається, а користувач дізнається, що зміни більше не зберігаються
+        if (session.journal != nullptr && session.journal -> failed()) {
+            std::cerr << "Помилка запису журналу " << journal_prefix << ".journal: подальші зміни не зберігаються\n";
+            session.journal = nullptr;
+        }
+    }
+    if (session.journal != nullptr && !session.journal -> flush()) {
+        std::cerr << "Помилка запису журналу " << journal_prefix << ".journal: частину змін не збережено\n";
+        result = 2;
     }
-    return 0;
-}
\ No newline at end of file
+    session.journal = nullptr;
+    delete journal;
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,14 @@
+#!/bin/sh
+# Регресійний тест: пісня з черги відтворення опиняється в другому плейлисті (обмін), після чого
+# злиття знищує вузли другого плейлиста. Черга не повинна містити знищених пісень, тому пункт 23
+# має показати порожню чергу, а AddressSanitizer - не знайти звернень до звільненої пам'яті.
+# Запуск з кореня репозиторію: sh tests/queue_after_merge.sh
+set -e
+bin="${TMPDIR:-/tmp}/playlist_queue_test_$$"
+trap 'rm -f "$bin"' EXIT
+${CXX:-g++} -std=c++17 -g -fsanitize=address,undefined -fno-sanitize-recover=all main.cpp -o "$bin"
+# 22 - додати в чергу, 12 - обмін, 13 - злиття, 23 - показати чергу, 0 - вихід
+output=$(printf '22\nImagine\n12\n13\n23\n0\n' | "$bin")
+echo "$output" | grep -q "Додано в чергу (1)" || { echo "FAIL: пісню не додано в чергу"; exit 1; }
+echo "$output" | grep -q "Черга порожня!" || { echo "FAIL: черга містить пісні, знищені злиттям"; exit 1; }
+echo "OK"